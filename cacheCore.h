@@ -0,0 +1,432 @@
+#ifndef _cacheCore_H
+#define _cacheCore_H
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+/**
+ * @file cacheCore.h
+ * @brief This defines the replacement logic of the cache as a header only
+ * library with no SST types, so it can be benchmarked on its own and reused
+ * by websiteCache. Every entry, table bucket and policy field is allocated
+ * when the cache is built, so with trivially copyable keys and values,
+ * lookups, inserts and evictions never allocate. Keys or values that own
+ * memory, such as the std::string page names and urls websiteCache stores,
+ * can still allocate when they are copied in on insert.
+ *
+ */
+
+/**
+ * @brief Capacity counted in entries, every entry costs one
+ *
+ */
+struct countCapacity {
+	countCapacity(uint32_t maxEntries) : maxEntries(maxEntries) {}
+
+	uint64_t limit() const { return maxEntries; }
+	uint64_t charge(uint64_t size) const { return 1; }
+	uint32_t entries() const { return maxEntries; }
+
+	uint32_t maxEntries;
+};
+
+/**
+ * @brief Capacity counted in bytes, every entry costs its size. The number
+ * of entries is also bounded, since their storage is allocated up front.
+ *
+ */
+struct byteCapacity {
+	byteCapacity(uint64_t maxBytes, uint32_t maxEntries) : maxBytes(maxBytes), maxEntries(maxEntries) {}
+
+	uint64_t limit() const { return maxBytes; }
+	uint64_t charge(uint64_t size) const { return size; }
+	uint32_t entries() const { return maxEntries; }
+
+	uint64_t maxBytes;
+	uint32_t maxEntries;
+};
+
+/**
+ * @brief Least recently used replacement, kept as a doubly linked list of
+ * entry slots so every operation is constant time
+ *
+ */
+class lruPolicy {
+
+public:
+	void reserve(uint32_t entries) {
+		prev.assign(entries, NONE);
+		next.assign(entries, NONE);
+		head = NONE;
+		tail = NONE;
+	}
+
+	void insert(uint32_t slot, uint64_t size) { pushFront(slot); }
+	void touch(uint32_t slot) { unlink(slot); pushFront(slot); }
+	void erase(uint32_t slot) { unlink(slot); }
+	void evict(uint32_t slot) { unlink(slot); }
+	uint32_t victim() const { return tail; }
+
+private:
+	void pushFront(uint32_t slot) {
+		prev[slot] = NONE;
+		next[slot] = head;
+		if (head != NONE) {
+			prev[head] = slot;
+		} else {
+			tail = slot;
+		}
+		head = slot;
+	}
+
+	void unlink(uint32_t slot) {
+		if (prev[slot] != NONE) {
+			next[prev[slot]] = next[slot];
+		} else {
+			head = next[slot];
+		}
+		if (next[slot] != NONE) {
+			prev[next[slot]] = prev[slot];
+		} else {
+			tail = prev[slot];
+		}
+	}
+
+	enum : uint32_t { NONE = UINT32_MAX };
+	std::vector<uint32_t> prev;		/* slot used just after this one */
+	std::vector<uint32_t> next;		/* slot used just before this one */
+	uint32_t head;					/* most recently used slot */
+	uint32_t tail;					/* least recently used slot, evicted first */
+};
+
+/**
+ * @brief Greedy dual size frequency replacement. An entry's priority is the
+ * inflation value plus its hits divided by its size, and the entry with the
+ * lowest priority is evicted, raising the inflation value to its priority so
+ * entries that stop being used eventually go. Priorities are kept in a
+ * four-ary min-heap that stores each priority next to its slot, so the
+ * children compared at each level share one cache line.
+ *
+ */
+class gdsfPolicy {
+
+public:
+	gdsfPolicy() : inflation(0) {}
+
+	void reserve(uint32_t entries) {
+		hits.assign(entries, 0);
+		sizes.assign(entries, 1);
+		heapIndex.assign(entries, 0);
+		heap.clear();
+		heap.reserve(entries);
+		inflation = 0;
+	}
+
+	void insert(uint32_t slot, uint64_t size) {
+		hits[slot] = 1;
+		sizes[slot] = size > 0 ? size : 1;
+		heapIndex[slot] = heap.size();
+		heap.push_back(heapEntry{ inflation + 1.0 / sizes[slot], slot });
+		siftUp(heapIndex[slot]);
+	}
+
+	void touch(uint32_t slot) {
+		// inflation never goes down, so a hit only raises the priority
+		hits[slot]++;
+		heap[heapIndex[slot]].priority = inflation + (double)hits[slot] / sizes[slot];
+		siftDown(heapIndex[slot]);
+	}
+
+	void erase(uint32_t slot) {
+		uint32_t index = heapIndex[slot];
+		heap[index] = heap.back();
+		heapIndex[heap[index].slot] = index;
+		heap.pop_back();
+		if (index < heap.size()) {
+			siftUp(index);
+			siftDown(index);
+		}
+	}
+
+	void evict(uint32_t slot) {
+		inflation = heap[heapIndex[slot]].priority;
+		erase(slot);
+	}
+
+	uint32_t victim() const { return heap.front().slot; }
+	double getInflation() const { return inflation; }
+
+private:
+	struct heapEntry {
+		double priority;	// GDSF priority of the slot
+		uint32_t slot;
+	};
+
+	void siftUp(uint32_t index) {
+		heapEntry entry = heap[index];
+		while (index > 0) {
+			uint32_t parent = (index - 1) / 4;
+			if (heap[parent].priority <= entry.priority) {
+				break;
+			}
+			place(index, heap[parent]);
+			index = parent;
+		}
+		place(index, entry);
+	}
+
+	void siftDown(uint32_t index) {
+		heapEntry entry = heap[index];
+		while (true) {
+			uint32_t first = 4 * index + 1;
+			if (first >= heap.size()) {
+				break;
+			}
+			uint32_t last = std::min<uint32_t>(first + 4, heap.size());
+			uint32_t smallest = first;
+			for (uint32_t child = first + 1; child < last; child++) {
+				if (heap[child].priority < heap[smallest].priority) {
+					smallest = child;
+				}
+			}
+			if (entry.priority <= heap[smallest].priority) {
+				break;
+			}
+			place(index, heap[smallest]);
+			index = smallest;
+		}
+		place(index, entry);
+	}
+
+	void place(uint32_t index, heapEntry entry) {
+		heap[index] = entry;
+		heapIndex[entry.slot] = index;
+	}
+
+	std::vector<uint64_t> hits;			/* requests for each slot since it was inserted */
+	std::vector<uint64_t> sizes;		/* size of each slot, at least 1 */
+	std::vector<uint32_t> heapIndex;	/* position of each slot in the heap */
+	std::vector<heapEntry> heap;		/* min-heap of slots by priority */
+	double inflation;					/* priority of the last eviction */
+};
+
+/**
+ * @brief A cache of values by key, with a replacement policy and a capacity
+ * model. Entries live in a fixed array of slots, found through an open
+ * addressing table of (hash, slot) pairs with linear probing, so a lookup
+ * usually reads one table cache line and compares the stored hash before
+ * touching the key. The table is kept at most half full, and removals shift
+ * later entries back instead of leaving tombstones.
+ *
+ * @tparam Key key type, hashed with Hash
+ * @tparam Value value stored for each key
+ * @tparam Policy replacement policy, lruPolicy or gdsfPolicy
+ * @tparam Capacity capacity model, countCapacity or byteCapacity
+ * @tparam Hash hash function of the keys
+ */
+template <typename Key, typename Value, typename Policy, typename Capacity, typename Hash = std::hash<Key>>
+class cacheCore {
+
+public:
+	cacheCore(Capacity capacity) : capacity(capacity), used(0), numEntries(0) {
+		uint32_t entries = capacity.entries();
+		nodes.resize(entries);
+		freeSlots.reserve(entries);
+		for (uint32_t slot = entries; slot > 0; slot--) {
+			freeSlots.push_back(slot - 1);
+		}
+		size_t buckets = 8;
+		while (buckets < (size_t)entries * 2) {
+			buckets <<= 1;
+		}
+		table.assign(buckets, bucket{ 0, EMPTY });
+		mask = buckets - 1;
+		policy.reserve(entries);
+	}
+
+	/**
+	 * @brief Looks up a key, counting it as a use for the replacement policy
+	 *
+	 * @return Value* The value, NULL on a miss. Valid until the next insert
+	 * or erase.
+	 */
+	Value * find(const Key &key) {
+		uint32_t slot = lookup(key);
+		if (slot == EMPTY) {
+			return NULL;
+		}
+		policy.touch(slot);
+		return &nodes[slot].value;
+	}
+
+	/**
+	 * @brief Looks up a key without counting it as a use
+	 *
+	 */
+	Value * peek(const Key &key) {
+		uint32_t slot = lookup(key);
+		return slot == EMPTY ? NULL : &nodes[slot].value;
+	}
+
+	bool contains(const Key &key) const { return lookup(key) != EMPTY; }
+
+	/**
+	 * @brief Inserts or replaces a key, evicting entries until it fits
+	 *
+	 * @param size Size of the entry, charged by the capacity model
+	 * @param onEvict Called with the key and value of each evicted entry
+	 * @return Value* The stored value, NULL if the entry is larger than the
+	 * whole cache
+	 */
+	template <typename OnEvict>
+	Value * insert(const Key &key, const Value &value, uint64_t size, OnEvict onEvict) {
+		uint64_t charge = capacity.charge(size);
+		if (charge > capacity.limit() || nodes.empty()) {
+			return NULL;
+		}
+		erase(key);
+		while (used + charge > capacity.limit() || freeSlots.empty()) {
+			uint32_t victim = policy.victim();
+			onEvict(nodes[victim].key, nodes[victim].value);
+			policy.evict(victim);
+			release(victim);
+		}
+
+		uint32_t slot = freeSlots.back();
+		freeSlots.pop_back();
+		node &entry = nodes[slot];
+		entry.key = key;
+		entry.value = value;
+		entry.charge = charge;
+		entry.hash = hashOf(key);
+		entry.live = true;
+		size_t index = entry.hash & mask;
+		while (table[index].slot != EMPTY) {
+			index = (index + 1) & mask;
+		}
+		table[index] = bucket{ entry.hash, slot };
+		policy.insert(slot, size);
+		used += charge;
+		numEntries++;
+		return &entry.value;
+	}
+
+	Value * insert(const Key &key, const Value &value, uint64_t size) {
+		return insert(key, value, size, [](const Key &, const Value &) {});
+	}
+
+	/**
+	 * @brief Removes a key
+	 *
+	 * @return true if the key was in the cache
+	 */
+	bool erase(const Key &key) {
+		uint32_t slot = lookup(key);
+		if (slot == EMPTY) {
+			return false;
+		}
+		policy.erase(slot);
+		release(slot);
+		return true;
+	}
+
+	/**
+	 * @brief Calls visit with the key and value of every entry, which must
+	 * not insert or erase while iterating
+	 *
+	 */
+	template <typename Visit>
+	void forEach(Visit visit) {
+		for (node &entry : nodes) {
+			if (entry.live) {
+				visit(entry.key, entry.value);
+			}
+		}
+	}
+
+	size_t size() const { return numEntries; }
+	uint64_t usedCapacity() const { return used; }
+	uint64_t capacityLimit() const { return capacity.limit(); }
+	const Policy & getPolicy() const { return policy; }
+
+private:
+	struct node {
+		Key key;
+		Value value;
+		uint64_t charge;	// capacity the entry uses
+		uint32_t hash;		// hash of the key, so removal does not rehash it
+		bool live;			// whether the slot holds an entry
+	};
+
+	struct bucket {
+		uint32_t hash;		// hash of the key, compared before the key
+		uint32_t slot;		// slot of the entry, EMPTY if the bucket is free
+	};
+
+	enum : uint32_t { EMPTY = UINT32_MAX };
+
+	uint32_t hashOf(const Key &key) const {
+		// mix the bits, since std::hash of an integer is the integer itself
+		uint64_t h = Hash()(key);
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdULL;
+		h ^= h >> 33;
+		return (uint32_t)h;
+	}
+
+	uint32_t lookup(const Key &key) const {
+		uint32_t hash = hashOf(key);
+		size_t index = hash & mask;
+		while (table[index].slot != EMPTY) {
+			if (table[index].hash == hash && nodes[table[index].slot].key == key) {
+				return table[index].slot;
+			}
+			index = (index + 1) & mask;
+		}
+		return EMPTY;
+	}
+
+	void release(uint32_t slot) {
+		size_t index = nodes[slot].hash & mask;
+		while (table[index].slot != slot) {
+			index = (index + 1) & mask;
+		}
+
+		// shift back any later bucket in the probe run that could no longer
+		// be reached once this one is empty
+		table[index].slot = EMPTY;
+		size_t next = index;
+		while (true) {
+			next = (next + 1) & mask;
+			if (table[next].slot == EMPTY) {
+				break;
+			}
+			size_t home = table[next].hash & mask;
+			bool reachable = index <= next ? (home > index && home <= next) : (home > index || home <= next);
+			if (!reachable) {
+				table[index] = table[next];
+				table[next].slot = EMPTY;
+				index = next;
+			}
+		}
+
+		nodes[slot].live = false;
+		used -= nodes[slot].charge;
+		numEntries--;
+		freeSlots.push_back(slot);
+	}
+
+	Capacity capacity;
+	Policy policy;
+	std::vector<node> nodes;			/* entry storage, indexed by slot */
+	std::vector<uint32_t> freeSlots;	/* slots without an entry */
+	std::vector<bucket> table;			/* open addressing table, a power of two long */
+	size_t mask;						/* table length minus one */
+	uint64_t used;						/* capacity used by the entries */
+	size_t numEntries;
+};
+
+#endif
@@ -0,0 +1,88 @@
+#include <sst/core/sst_config.h>
+#include "circuitBreaker.h"
+
+circuitBreaker::circuitBreaker(breakerSettings settings, std::function<void(breakerState, breakerState)> onTransition) :
+    settings(settings),
+    onTransition(onTransition),
+    state(BREAKER_CLOSED),
+    openedAt(0),
+    probesSent(0),
+    probesPassed(0),
+    calls(settings.windowLength, 10),
+    failures(settings.windowLength, 10)
+{}
+
+bool circuitBreaker::allowRequest(uint64_t now) {
+    switch (getState(now)) {
+    case BREAKER_CLOSED:
+        return true;
+    case BREAKER_HALF_OPEN:
+        // only a few probes go through, the rest are treated as open
+        if (probesSent < settings.probeCalls) {
+            probesSent++;
+            return true;
+        }
+        return false;
+    default:
+        return false;
+    }
+}
+
+void circuitBreaker::recordResponse(uint64_t now, uint64_t latency, bool successful) {
+    recordOutcome(now, !successful || latency > settings.slowCallLength);
+}
+
+void circuitBreaker::recordTimeout(uint64_t now) {
+    recordOutcome(now, true);
+}
+
+breakerState circuitBreaker::getState(uint64_t now) {
+    if (state == BREAKER_OPEN && now >= openedAt + settings.openLength) {
+        transition(BREAKER_HALF_OPEN, now);
+    }
+    return state;
+}
+
+void circuitBreaker::recordOutcome(uint64_t now, bool failed) {
+    switch (getState(now)) {
+    case BREAKER_CLOSED:
+        calls.add(now);
+        if (failed) {
+            failures.add(now);
+        } else {
+            failures.advance(now);
+        }
+        if (calls.count() >= settings.minimumCalls &&
+            (double)failures.count() / calls.count() >= settings.failureRate) {
+            transition(BREAKER_OPEN, now);
+        }
+        break;
+    case BREAKER_HALF_OPEN:
+        // one failed probe means the server has not recovered yet
+        if (failed) {
+            transition(BREAKER_OPEN, now);
+        } else if (++probesPassed >= settings.probeCalls) {
+            transition(BREAKER_CLOSED, now);
+        }
+        break;
+    default:
+        // responses to misses forwarded before the breaker opened
+        break;
+    }
+}
+
+void circuitBreaker::transition(breakerState newState, uint64_t now) {
+    breakerState oldState = state;
+    state = newState;
+    if (newState == BREAKER_OPEN) {
+        openedAt = now;
+    } else if (newState == BREAKER_HALF_OPEN) {
+        probesSent = 0;
+        probesPassed = 0;
+    } else if (newState == BREAKER_CLOSED) {
+        // start measuring again from a clean window
+        calls = slidingWindow(settings.windowLength, 10);
+        failures = slidingWindow(settings.windowLength, 10);
+    }
+    onTransition(oldState, newState);
+}
@@ -0,0 +1,103 @@
+#ifndef _circuitBreaker_H
+#define _circuitBreaker_H
+
+#include <functional>
+#include "herdMetrics.h"
+
+/**
+ * @file circuitBreaker.h
+ * @brief This defines a circuit breaker the cache puts in front of the
+ * server, so that once the server is slow or failing the cache stops
+ * forwarding every miss to it and lets it recover
+ *
+ */
+
+/**
+ * @brief The states of the circuit breaker. Closed forwards every miss, open
+ * forwards none, and half-open forwards a few probes to test the server.
+ *
+ */
+enum breakerState {
+	BREAKER_CLOSED,
+	BREAKER_OPEN,
+	BREAKER_HALF_OPEN
+};
+
+/**
+ * @brief Settings of the circuit breaker, times are in nanoseconds
+ *
+ */
+struct breakerSettings {
+	uint64_t slowCallLength;	// a server response slower than this counts as a failure
+	uint64_t windowLength;		// sliding window the failure rate is measured over
+	uint64_t minimumCalls;		// calls needed in the window before the breaker can open
+	double failureRate;			// fraction of failed calls in the window that opens the breaker
+	uint64_t openLength;		// how long the breaker stays open before probing
+	uint64_t probeCalls;		// successful probes needed in half-open to close again
+};
+
+class circuitBreaker {
+
+public:
+	/**
+	 * @brief Construct a new circuit breaker, starting closed
+	 *
+	 * @param settings Thresholds and timings of the breaker
+	 * @param onTransition Called with the old and new state on every change
+	 */
+	circuitBreaker(breakerSettings settings, std::function<void(breakerState, breakerState)> onTransition);
+
+	/**
+	 * @brief Asks whether a miss may be forwarded to the server. In
+	 * half-open, each allowed call uses up one probe.
+	 *
+	 * @param now Current sim time in nanoseconds
+	 * @return true if the miss should go to the server
+	 */
+	bool allowRequest(uint64_t now);
+
+	/**
+	 * @brief Records the server answering a forwarded miss
+	 *
+	 * @param now Current sim time in nanoseconds
+	 * @param latency Time between forwarding the miss and the response
+	 * @param successful Whether the server returned the page
+	 */
+	void recordResponse(uint64_t now, uint64_t latency, bool successful);
+
+	/**
+	 * @brief Records a forwarded miss that has gone unanswered for longer
+	 * than the slow call length
+	 *
+	 * @param now Current sim time in nanoseconds
+	 */
+	void recordTimeout(uint64_t now);
+
+	/**
+	 * @brief Current state, moving from open to half-open once the open
+	 * length has passed
+	 *
+	 * @param now Current sim time in nanoseconds
+	 */
+	breakerState getState(uint64_t now);
+
+private:
+	/**
+	 * @brief Counts one outcome and changes state if it calls for it
+	 *
+	 */
+	void recordOutcome(uint64_t now, bool failed);
+
+	void transition(breakerState newState, uint64_t now);
+
+	breakerSettings settings;
+	std::function<void(breakerState, breakerState)> onTransition;
+	breakerState state;
+	uint64_t openedAt;			/* time the breaker last opened */
+	uint64_t probesSent;		/* probes allowed through while half-open */
+	uint64_t probesPassed;		/* probes answered in time while half-open */
+	slidingWindow calls;		/* outcomes in the window while closed */
+	slidingWindow failures;		/* failed outcomes in the window while closed */
+};
+
+#endif
@@ -0,0 +1,95 @@
+#include <sst/core/sst_config.h>
+#include "herdMetrics.h"
+
+herdDetector::herdDetector(SST::Output *output, uint64_t windowLength, int numBuckets, std::vector<double> thresholds) :
+    output(output),
+    windowLength(windowLength),
+    numBuckets(numBuckets),
+    duplicateMisses(windowLength, numBuckets),
+    firstRequests(windowLength, numBuckets),
+    retryRequests(windowLength, numBuckets),
+    interArrivals(windowLength, numBuckets),
+    lastArrival(0),
+    seenArrival(false)
+{
+    // thresholds are passed in the order page rate, duplicate misses,
+    // retry ratio, burstiness
+    thresholds.resize(4, 0);
+    pageRateThreshold = thresholds[0];
+    duplicateMissAlarm = { "duplicate in-flight misses", thresholds[1], false, 0 };
+    retryRatioAlarm = { "retry to first request ratio", thresholds[2], false, 0 };
+    burstinessAlarm = { "inter-arrival burstiness", thresholds[3], false, 0 };
+}
+
+void herdDetector::recordRequest(uint64_t now, const std::string &page, bool retry) {
+    // per page request rate over the window
+    auto it = pageRequests.find(page);
+    if (it == pageRequests.end()) {
+        pageMetrics metrics = { slidingWindow(windowLength, numBuckets), { "page request rate", pageRateThreshold, false, 0 } };
+        it = pageRequests.emplace(page, metrics).first;
+    }
+    slidingWindow &requests = it->second.requests;
+    requests.add(now);
+    checkAlarm(it->second.rateAlarm, requests.count() / requests.lengthSeconds(), now, page);
+
+    // retries against first requests, both windows advanced so they line up
+    if (retry) {
+        retryRequests.add(now);
+        firstRequests.advance(now);
+    } else {
+        firstRequests.add(now);
+        retryRequests.advance(now);
+    }
+    double ratio = (double)retryRequests.count() / std::max<uint64_t>(firstRequests.count(), 1);
+    checkAlarm(retryRatioAlarm, ratio, now, "");
+
+    // synchronized users arrive in bursts, which raises the spread of the gaps
+    if (seenArrival) {
+        interArrivals.add(now, (double)(now - lastArrival));
+        checkAlarm(burstinessAlarm, interArrivals.coefficientOfVariation(), now, "");
+    }
+    lastArrival = now;
+    seenArrival = true;
+}
+
+void herdDetector::recordMiss(uint64_t now, const std::string &page) {
+    // a miss for a page the server is already fetching is duplicated work
+    int &inFlight = inFlightMisses[page];
+    if (inFlight > 0) {
+        duplicateMisses.add(now);
+    } else {
+        duplicateMisses.advance(now);
+    }
+    inFlight++;
+    checkAlarm(duplicateMissAlarm, duplicateMisses.count(), now, page);
+}
+
+void herdDetector::recordFill(const std::string &page) {
+    inFlightMisses[page] = 0;
+}
+
+void herdDetector::printSummary() {
+    for (auto &page : pageRequests) {
+        output->output(CALL_INFO, "peak request rate for %s: %f \n", page.first.c_str(), page.second.rateAlarm.peak);
+    }
+    for (herdAlarm *alarm : { &duplicateMissAlarm, &retryRatioAlarm, &burstinessAlarm }) {
+        output->output(CALL_INFO, "peak %s: %f \n", alarm->name.c_str(), alarm->peak);
+    }
+}
+
+void herdDetector::checkAlarm(herdAlarm &alarm, double value, uint64_t now, const std::string &detail) {
+    alarm.peak = std::max(alarm.peak, value);
+    if (alarm.threshold <= 0) {
+        return;
+    }
+    // only log when the metric crosses the threshold, not on every event
+    if (!alarm.raised && value >= alarm.threshold) {
+        alarm.raised = true;
+        output->output(CALL_INFO, "HERD ALARM at %lu ns: %s %s is %f (threshold %f)\n",
+            now, alarm.name.c_str(), detail.c_str(), value, alarm.threshold);
+    } else if (alarm.raised && value < alarm.threshold) {
+        alarm.raised = false;
+        output->output(CALL_INFO, "herd alarm cleared at %lu ns: %s %s is %f \n",
+            now, alarm.name.c_str(), detail.c_str(), value);
+    }
+}
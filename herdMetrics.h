@@ -0,0 +1,223 @@
+#ifndef _herdMetrics_H
+#define _herdMetrics_H
+
+#include <sst/core/output.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file herdMetrics.h
+ * @brief This defines streaming metrics used by the cache to detect when a
+ * thundering herd is happening, along with alarms that log when a metric
+ * crosses its threshold
+ *
+ */
+
+/**
+ * @brief A sliding window over simulated time, split into a ring of buckets.
+ * Each bucket keeps a count, sum and sum of squares, so the totals for the
+ * whole window are updated in constant time as buckets expire.
+ *
+ */
+class slidingWindow {
+
+public:
+	/**
+	 * @brief Construct a new sliding window
+	 *
+	 * @param windowLength Length of the window in nanoseconds
+	 * @param numBuckets How many buckets the window is split into
+	 */
+	slidingWindow(uint64_t windowLength, int numBuckets) :
+		bucketLength(std::max<uint64_t>(windowLength / numBuckets, 1)),
+		currentBucket(0),
+		counts(numBuckets, 0),
+		sums(numBuckets, 0),
+		squares(numBuckets, 0),
+		totalCount(0),
+		totalSum(0),
+		totalSquares(0)
+	{}
+
+	/**
+	 * @brief Adds a sample to the window at the given time
+	 *
+	 * @param now Current sim time in nanoseconds
+	 * @param value Value of the sample, 1 when only counting events
+	 */
+	void add(uint64_t now, double value = 1) {
+		advance(now);
+		int slot = currentBucket % counts.size();
+		counts[slot]++;
+		sums[slot] += value;
+		squares[slot] += value * value;
+		totalCount++;
+		totalSum += value;
+		totalSquares += value * value;
+	}
+
+	/**
+	 * @brief Expires every bucket that is older than the window
+	 *
+	 * @param now Current sim time in nanoseconds
+	 */
+	void advance(uint64_t now) {
+		uint64_t bucket = now / bucketLength;
+		if (bucket <= currentBucket) {
+			return;
+		}
+		// at most one full lap of the ring needs to be cleared
+		uint64_t expired = std::min<uint64_t>(bucket - currentBucket, counts.size());
+		for (uint64_t i = 1; i <= expired; i++) {
+			int slot = (currentBucket + i) % counts.size();
+			totalCount -= counts[slot];
+			totalSum -= sums[slot];
+			totalSquares -= squares[slot];
+			counts[slot] = 0;
+			sums[slot] = 0;
+			squares[slot] = 0;
+		}
+		currentBucket = bucket;
+	}
+
+	uint64_t count() const { return totalCount; }
+	double sum() const { return totalSum; }
+
+	/**
+	 * @brief Coefficient of variation (standard deviation over mean) of the
+	 * samples in the window, 0 if there are not enough samples
+	 *
+	 */
+	double coefficientOfVariation() const {
+		if (totalCount < 2 || totalSum <= 0) {
+			return 0;
+		}
+		double mean = totalSum / totalCount;
+		double variance = std::max(totalSquares / totalCount - mean * mean, 0.0);
+		return std::sqrt(variance) / mean;
+	}
+
+	/**
+	 * @brief Length of the window in seconds, used to turn counts into rates
+	 *
+	 */
+	double lengthSeconds() const { return bucketLength * counts.size() / 1e9; }
+
+private:
+	uint64_t bucketLength;			/* nanoseconds covered by each bucket */
+	uint64_t currentBucket;			/* index of the newest bucket since time 0 */
+	std::vector<uint64_t> counts;	/* samples per bucket */
+	std::vector<double> sums;		/* sum of samples per bucket */
+	std::vector<double> squares;	/* sum of squared samples per bucket */
+	uint64_t totalCount;
+	double totalSum;
+	double totalSquares;
+};
+
+/**
+ * @brief A threshold on a metric which logs once when the metric rises above
+ * it, and once again when the metric falls back below it
+ *
+ */
+struct herdAlarm {
+	std::string name;	// name of the metric for the log
+	double threshold;	// 0 disables the alarm
+	bool raised;		// whether the metric is currently above threshold
+	double peak;		// highest value seen during the simulation
+};
+
+/**
+ * @brief The request rate window of a single page, with its own alarm so
+ * that pages raise and clear independently of each other
+ *
+ */
+struct pageMetrics {
+	slidingWindow requests;
+	herdAlarm rateAlarm;
+};
+
+/**
+ * @brief Tracks the metrics that identify a thundering herd at the cache:
+ * - per page request rate
+ * - duplicate misses sent to the server for a page already in flight
+ * - ratio of user retries to first requests
+ * - burstiness of request arrivals (coefficient of variation)
+ *
+ * Each event costs a constant amount of work, so it can stay enabled in
+ * large simulations.
+ *
+ */
+class herdDetector {
+
+public:
+	/**
+	 * @brief Construct a new herd detector
+	 *
+	 * @param output Output used to log alarms
+	 * @param windowLength Length of the sliding windows in nanoseconds
+	 * @param numBuckets How many buckets each window is split into
+	 * @param thresholds Alarm thresholds for page rate, duplicate misses,
+	 * retry ratio and burstiness, 0 disables an alarm
+	 */
+	herdDetector(SST::Output *output, uint64_t windowLength, int numBuckets, std::vector<double> thresholds);
+
+	/**
+	 * @brief Records a request from a user arriving at the cache
+	 *
+	 * @param now Current sim time in nanoseconds
+	 * @param page Name of the page requested
+	 * @param retry Whether this is a re-request after the user timed out
+	 */
+	void recordRequest(uint64_t now, const std::string &page, bool retry);
+
+	/**
+	 * @brief Records a miss being sent to the server
+	 *
+	 * @param now Current sim time in nanoseconds
+	 * @param page Name of the page that missed
+	 */
+	void recordMiss(uint64_t now, const std::string &page);
+
+	/**
+	 * @brief Records the server filling a page, ending its in-flight misses
+	 *
+	 * @param page Name of the page that was filled
+	 */
+	void recordFill(const std::string &page);
+
+	/**
+	 * @brief Logs the peak value of every metric
+	 *
+	 */
+	void printSummary();
+
+private:
+	/**
+	 * @brief Compares a metric against its alarm, logging when it changes side
+	 *
+	 */
+	void checkAlarm(herdAlarm &alarm, double value, uint64_t now, const std::string &detail);
+
+	SST::Output *output;
+	uint64_t windowLength;
+	int numBuckets;
+
+	std::unordered_map<std::string, pageMetrics> pageRequests;		/* request rate per page */
+	std::unordered_map<std::string, int> inFlightMisses;			/* misses sent to server, per page */
+	slidingWindow duplicateMisses;	/* misses for a page already in flight */
+	slidingWindow firstRequests;	/* new requests from users */
+	slidingWindow retryRequests;	/* re-requests from impatient users */
+	slidingWindow interArrivals;	/* gaps between user requests */
+	uint64_t lastArrival;			/* time of the previous user request */
+	bool seenArrival;
+
+	double pageRateThreshold;
+	herdAlarm duplicateMissAlarm;
+	herdAlarm retryRatioAlarm;
+	herdAlarm burstinessAlarm;
+};
+
+#endif
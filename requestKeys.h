@@ -0,0 +1,70 @@
+#ifndef _requestKeys_H
+#define _requestKeys_H
+
+#include <unordered_map>
+
+/**
+ * @file requestKeys.h
+ * @brief This defines a filter on (user, sequence) idempotency keys, used by
+ * the cache and the server to drop queued requests that a user has already
+ * replaced, so retries replace work instead of adding to it
+ *
+ */
+
+/**
+ * @brief Users number each new page request, and re-send the same number
+ * when they retry. For each user this keeps the newest number seen and how
+ * many requests with that number are waiting in the queue.
+ *
+ */
+class supersededFilter {
+
+public:
+	/**
+	 * @brief Called when a request arrives, before it is queued
+	 *
+	 * @param user id of the user who sent the request
+	 * @param sequence the user's number for the request
+	 * @return true if the request should be queued, false if it is older
+	 * than the user's newest request or a copy of one already queued
+	 */
+	bool admit(int64_t user, uint64_t sequence) {
+		userKey &key = users[user];
+		if (sequence > key.latestSequence) {
+			// the user moved on, anything still queued is now superseded
+			key.latestSequence = sequence;
+			key.queued = 0;
+		} else if (sequence < key.latestSequence || key.queued > 0) {
+			return false;
+		}
+		key.queued++;
+		return true;
+	}
+
+	/**
+	 * @brief Called when a request is taken off the queue
+	 *
+	 * @param user id of the user who sent the request
+	 * @param sequence the user's number for the request
+	 * @return true if the request should be processed, false if a newer
+	 * request from the same user arrived while it was queued
+	 */
+	bool release(int64_t user, uint64_t sequence) {
+		userKey &key = users[user];
+		if (sequence < key.latestSequence) {
+			return false;
+		}
+		key.queued--;
+		return true;
+	}
+
+private:
+	struct userKey {
+		uint64_t latestSequence = 0;	// newest request number seen from the user
+		int queued = 0;					// queued requests with that number
+	};
+
+	std::unordered_map<int64_t, userKey> users;
+};
+
+#endif
@@ -0,0 +1,87 @@
+#include <sst/core/sst_config.h>
+#include "requestScheduler.h"
+
+void fairQueue::push(CacheRequestEvent *ev) {
+    userQueue &queue = users[ev->cachereq.id];
+    // a user with nothing queued joins the back of the round
+    if (queue.requests.empty()) {
+        queue.deficit = 0;
+        activeUsers.push_back(ev->cachereq.id);
+    }
+    queue.requests.push_back(ev);
+    numRequests++;
+}
+
+CacheRequestEvent * fairQueue::pop() {
+    if (activeUsers.empty()) {
+        return NULL;
+    }
+
+    // the user at the front gets a new quantum when their turn starts
+    int64_t user = activeUsers.front();
+    userQueue &queue = users[user];
+    if (queue.deficit <= 0) {
+        queue.deficit += quantum;
+    }
+
+    CacheRequestEvent *ev = queue.requests.front();
+    queue.requests.pop_front();
+    queue.deficit--;
+    numRequests--;
+
+    // users with nothing left leave the round, users out of quantum wait
+    // for their next turn
+    if (queue.requests.empty()) {
+        activeUsers.pop_front();
+        users.erase(user);
+    } else if (queue.deficit <= 0) {
+        activeUsers.pop_front();
+        activeUsers.push_back(user);
+    }
+    return ev;
+}
+
+requestScheduler::requestScheduler(bool fairQueueing, int quantum, int firstWeight, int retryWeight) :
+    fairQueueing(fairQueueing),
+    firstRequests(quantum),
+    retryRequests(quantum),
+    firstWeight(firstWeight),
+    retryWeight(retryWeight),
+    servingRetries(false),
+    turnCredit(firstWeight)
+{}
+
+void requestScheduler::push(CacheRequestEvent *ev) {
+    if (!fairQueueing || ev->cachereq.request != USER) {
+        priorityRequests.push_back(ev);
+    } else if (ev->cachereq.retryCount == 0) {
+        firstRequests.push(ev);
+    } else {
+        retryRequests.push(ev);
+    }
+}
+
+CacheRequestEvent * requestScheduler::pop() {
+    // server messages have strict priority over the user classes
+    if (!priorityRequests.empty()) {
+        CacheRequestEvent *ev = priorityRequests.front();
+        priorityRequests.pop_front();
+        return ev;
+    }
+    if (firstRequests.size() == 0 && retryRequests.size() == 0) {
+        return NULL;
+    }
+
+    // a class keeps the turn until it runs out of credit or requests, an 
+    // empty class gives up the rest of its turn, so at most two hand overs 
+    // are needed to find a request
+    while (true) {
+        fairQueue &queue = servingRetries ? retryRequests : firstRequests;
+        if (turnCredit > 0 && queue.size() > 0) {
+            turnCredit--;
+            return queue.pop();
+        }
+        servingRetries = !servingRetries;
+        turnCredit = servingRetries ? retryWeight : firstWeight;
+    }
+}
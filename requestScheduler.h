@@ -0,0 +1,105 @@
+#ifndef _requestScheduler_H
+#define _requestScheduler_H
+
+#include <sst/core/event.h>
+#include <deque>
+#include <unordered_map>
+#include "requests.h"
+
+/**
+ * @file requestScheduler.h
+ * @brief This defines the queue the cache takes its requests from, which
+ * keeps impatient users' retries from getting ahead of everyone else
+ *
+ */
+
+/**
+ * @brief Requests from users in one priority class, served with deficit
+ * round-robin so every user with a pending request gets a turn before any
+ * user gets a second one
+ *
+ */
+class fairQueue {
+
+public:
+	fairQueue(int quantum) : quantum(quantum), numRequests(0) {}
+
+	/**
+	 * @brief Adds a request to the back of its user's queue
+	 *
+	 */
+	void push(CacheRequestEvent *ev);
+
+	/**
+	 * @brief Takes the next request in round-robin order
+	 *
+	 * @return CacheRequestEvent* The request, NULL if there are none
+	 */
+	CacheRequestEvent * pop();
+
+	size_t size() const { return numRequests; }
+
+private:
+	struct userQueue {
+		std::deque<CacheRequestEvent*> requests;	// pending requests of this user
+		int deficit;								// requests the user may still send this round
+	};
+
+	int quantum;										/* requests per user per round */
+	size_t numRequests;
+	std::unordered_map<int64_t, userQueue> users;		/* queue of each user */
+	std::deque<int64_t> activeUsers;					/* users with pending requests, in turn order */
+};
+
+/**
+ * @brief Orders requests waiting at the cache. Server fills and
+ * invalidations have strict priority, since they complete work that users
+ * are already waiting on or stop stale pages from being served. Users'
+ * first requests and retries then take turns in weighted round-robin, so
+ * first requests get most of the cache but retries are never starved, as
+ * a user whose request missed only gets the page by retrying. Within each
+ * of those classes every user is served in deficit round-robin order.
+ * With fair queueing off it is a single FIFO, like the original cache
+ * queue.
+ *
+ */
+class requestScheduler {
+
+public:
+	/**
+	 * @brief Construct a new request scheduler
+	 *
+	 * @param fairQueueing Whether to use the priority classes, or one FIFO
+	 * @param quantum Requests each user may send per round-robin turn
+	 * @param firstWeight First requests taken per turn of their class
+	 * @param retryWeight Retries taken per turn of their class
+	 */
+	requestScheduler(bool fairQueueing, int quantum, int firstWeight, int retryWeight);
+
+	/**
+	 * @brief Adds a request to the queue of its class
+	 *
+	 */
+	void push(CacheRequestEvent *ev);
+
+	/**
+	 * @brief Takes the next request to process
+	 *
+	 * @return CacheRequestEvent* The request, NULL if there are none
+	 */
+	CacheRequestEvent * pop();
+
+	size_t size() const { return priorityRequests.size() + firstRequests.size() + retryRequests.size(); }
+
+private:
+	bool fairQueueing;
+	std::deque<CacheRequestEvent*> priorityRequests;	/* server messages, or everything when fair queueing is off */
+	fairQueue firstRequests;							/* requests users have not retried yet */
+	fairQueue retryRequests;							/* re-requests from impatient users */
+	int firstWeight;
+	int retryWeight;
+	bool servingRetries;								/* whether the retry class has the current turn */
+	int turnCredit;										/* requests the current class may still take this turn */
+};
+
+#endif
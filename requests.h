@@ -5,6 +5,9 @@
  * 
  */
 
+#ifndef _requests_H
+#define _requests_H
+
 /**
  * @brief This is used for our websiteUser components, and it keeps track 
  * of which state they are currently in
@@ -19,12 +22,14 @@ enum userStatus {
 
 /**
  * @brief This is used by the cache to keep track of whether incoming 
- * messages are coming from the user or from the server  
+ * messages are coming from the user or from the server, and whether a 
+ * message from the server is a page or an invalidation of cached pages
  * 
  */
 enum requester {
 	USER,
-	SERVER
+	SERVER,
+	INVALIDATION
 };
 
 /**
@@ -35,6 +40,7 @@ enum requester {
 struct UserRequest { 
 	std::string websiteUrl;
 	bool validSite;
+	int64_t userID;		// user the reply is for, used by userPopulation
 };
 
 /**
@@ -45,9 +51,12 @@ struct UserRequest {
 struct CacheRequest { 
 	requester request;			// differentiates users from server
 	int64_t id; 				// 0 for server, 1+ for users
-	std::string pageRequested;	// name of website
+	std::string pageRequested;	// name of website, empty for an invalidation of every page
 	std::string urlRequested;	// url (only used by server)
 	bool successfulReturn; 		// for server to use to mark success of request
+	uint64_t pageSize;			// size of the page in bytes (only used by server)
+	int retryCount;				// times the user re-requested this page (only used by users)
+	uint64_t sequence;			// user's number for this request, the same on every retry
 };
 
 /**
@@ -58,18 +67,28 @@ struct CacheRequest {
 struct ServerRequest { 
 	std::string pageRequested;
 	int64_t id; // id of user requesting page (may or may not be necessary)
-
+	uint64_t sequence; // user's number for the request, with id forms its idempotency key
 };
 
 /**
- * @brief This is an object to be used in the map for the cache, which keeps 
- * traack of both the url, and how recently this url was last accessed so we 
- * can implement a LRU policy.
+ * @brief This is a page held by the cache. How recently and how often it was 
+ * used is tracked by the cache's replacement policy (see cacheCore.h).
  * 
  */
 struct cacheObject {
 	std::string websiteUrl;
-	long unsigned int websiteAge;
+	uint64_t websiteSize;		// size of the page in bytes
+};
+
+/**
+ * @brief This is an entry in the server's catalog of websites, holding the 
+ * url of the page and how many bytes it takes to send it
+ * 
+ */
+struct websitePage {
+	std::string websiteUrl;
+	uint64_t websiteSize;
+	uint64_t websiteVersion;	// times the page has been updated
 };
 
 /*! 
@@ -88,6 +107,7 @@ public:
 		Event::serialize_order(ser);
 		ser & userreq.websiteUrl;
 		ser & userreq.validSite;
+		ser & userreq.userID;
 	}
 	
 	/**
@@ -128,6 +148,9 @@ public:
 		ser & cachereq.pageRequested;
 		ser & cachereq.urlRequested;
 		ser & cachereq.successfulReturn;
+		ser & cachereq.pageSize;
+		ser & cachereq.retryCount;
+		ser & cachereq.sequence;
 	}
 	
 	/**
@@ -165,6 +188,7 @@ public:
 		Event::serialize_order(ser);
 		ser & serverreq.pageRequested;
 		ser & serverreq.id;
+		ser & serverreq.sequence;
 	}
 	
 	/**
@@ -185,3 +209,5 @@ public:
 	// this serializes the event we created so it can be sent over a link
 	ImplementSerializable(ServerRequestEvent); 
 };
+
+#endif
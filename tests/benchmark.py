@@ -0,0 +1,176 @@
+"""Benchmark sweep and performance regression check for the element library.
+
+Runs tests/benchmarkModel.py across a sweep of user counts, cache sizes,
+replacement policies and SST thread counts. Every component runs with
+verbose 1, so the timings are not dominated by per event logging. For every
+run it records wall time, requests processed by the cache and server per
+second of wall time, peak resident memory and the model
+metrics printed by the cache at the end of the simulation, writes them to a
+JSON results file and compares them against a stored baseline.
+
+    python3 tests/benchmark.py                   # quick sweep, compare to baseline
+    python3 tests/benchmark.py --sweep full      # 10 to 100k users
+    python3 tests/benchmark.py --update-baseline # store results as the new baseline
+"""
+import argparse
+import itertools
+import json
+import os
+import re
+import subprocess
+import sys
+import time
+
+SWEEPS = {
+    "quick": {
+        "users": [10, 100, 1000],
+        "cacheBytes": [131072],
+        "policy": ["lru", "gdsf"],
+        "threads": [1],
+        "population": [False],
+    },
+    "full": {
+        "users": [10, 100, 1000, 10000, 100000],
+        "cacheBytes": [32768, 131072, 524288],
+        "policy": ["lru", "gdsf"],
+        "threads": [1, 2, 4],
+        "population": [False, True],
+    },
+}
+
+PROCESSED = re.compile(r"^(websiteCache|websiteServer)-.*processed (\d+) requests")
+SUPERSEDED = re.compile(r"^(websiteCache|websiteServer)-.*dropped (\d+) superseded")
+PEAK = re.compile(r"^websiteCache-.*peak (.+): ([0-9.]+)")
+
+
+def runPoint(args, users, cacheBytes, policy, threads, population):
+    """Runs one point of the sweep and returns its measurements."""
+    modelOptions = "--users %d --cacheBytes %d --policy %s" % (users, cacheBytes, policy)
+    if population:
+        modelOptions += " --population"
+    command = [
+        args.sst,
+        "-n",
+        str(threads),
+        "--stopAtCycle=%s" % args.stop,
+        "--model-options=%s" % modelOptions,
+        args.model,
+    ]
+    result = {"processed": {}, "superseded": {}, "metrics": {}, "alarms": 0}
+
+    start = time.perf_counter()
+    process = subprocess.Popen(command, stdout=subprocess.PIPE, universal_newlines=True)
+    # scan the summary lines as they stream by
+    for line in process.stdout:
+        processed = PROCESSED.match(line)
+        superseded = SUPERSEDED.match(line)
+        peak = PEAK.match(line)
+        if processed:
+            result["processed"][processed.group(1)] = int(processed.group(2))
+        elif superseded:
+            result["superseded"][superseded.group(1)] = int(superseded.group(2))
+        elif peak:
+            result["metrics"][peak.group(1)] = float(peak.group(2))
+        elif "HERD ALARM" in line:
+            result["alarms"] += 1
+    # wait4 gives the resource usage of this run only
+    _, status, usage = os.wait4(process.pid, 0)
+    wallTime = time.perf_counter() - start
+    returnCode = os.WEXITSTATUS(status) if os.WIFEXITED(status) else -os.WTERMSIG(status)
+
+    if returnCode != 0:
+        sys.exit("sst failed with code %d: %s" % (returnCode, " ".join(command)))
+
+    requests = sum(result["processed"].values())
+    result["wallTime"] = wallTime
+    result["requestsPerSec"] = requests / wallTime if wallTime > 0 else 0.0
+    result["peakRssKB"] = usage.ru_maxrss
+    return result
+
+
+def compare(results, baseline, tolerance):
+    """Returns a list of regressions of results against the baseline."""
+    regressions = []
+    for key, result in results.items():
+        if key not in baseline:
+            continue
+        base = baseline[key]
+        if result["wallTime"] > base["wallTime"] * (1 + tolerance):
+            regressions.append("%s: wall time %.2fs, baseline %.2fs" % (key, result["wallTime"], base["wallTime"]))
+        if result["requestsPerSec"] < base["requestsPerSec"] * (1 - tolerance):
+            regressions.append(
+                "%s: %.0f requests/sec, baseline %.0f" % (key, result["requestsPerSec"], base["requestsPerSec"])
+            )
+        if result["peakRssKB"] > base["peakRssKB"] * (1 + tolerance):
+            regressions.append("%s: peak RSS %dKB, baseline %dKB" % (key, result["peakRssKB"], base["peakRssKB"]))
+        # the model is deterministic, so changed metrics mean changed behaviour
+        # rather than a slower simulator, report them without failing
+        if result["processed"] != base["processed"] or result["metrics"] != base["metrics"]:
+            print("model output changed for %s" % key)
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--sweep", choices=sorted(SWEEPS), default="quick")
+    parser.add_argument("--stop", default="1000s", help="simulated time for each run")
+    parser.add_argument("--sst", default="sst")
+    parser.add_argument("--model", default=os.path.join(os.path.dirname(__file__), "benchmarkModel.py"))
+    parser.add_argument("--results", default="benchmarkResults.json")
+    parser.add_argument("--baseline", default=os.path.join(os.path.dirname(__file__), "benchmarkBaseline.json"))
+    parser.add_argument("--tolerance", type=float, default=0.2, help="allowed relative slowdown")
+    parser.add_argument("--update-baseline", action="store_true")
+    args = parser.parse_args()
+
+    sweep = SWEEPS[args.sweep]
+    results = {}
+    for users, cacheBytes, policy, threads, population in itertools.product(
+        sweep["users"], sweep["cacheBytes"], sweep["policy"], sweep["threads"], sweep["population"]
+    ):
+        key = "users=%d,cacheBytes=%d,policy=%s,threads=%d" % (users, cacheBytes, policy, threads)
+        if population:
+            key += ",population"
+        print("running %s" % key, flush=True)
+        results[key] = runPoint(args, users, cacheBytes, policy, threads, population)
+        print(
+            "  %.2fs, %.0f requests/sec, %dKB peak RSS"
+            % (results[key]["wallTime"], results[key]["requestsPerSec"], results[key]["peakRssKB"])
+        )
+
+    with open(args.results, "w") as resultsFile:
+        json.dump(results, resultsFile, indent=2, sort_keys=True)
+
+    # keep baseline entries from sweeps that were not run this time
+    baseline = {}
+    if os.path.exists(args.baseline):
+        with open(args.baseline) as baselineFile:
+            baseline = json.load(baselineFile)
+
+    if args.update_baseline:
+        baseline.update(results)
+        with open(args.baseline, "w") as baselineFile:
+            json.dump(baseline, baselineFile, indent=2, sort_keys=True)
+        print("baseline written to %s" % args.baseline)
+        return
+
+    # points with no baseline yet (every point on a fresh checkout) are
+    # recorded as the baseline, so the next run has something to compare to
+    missing = sorted(key for key in results if key not in baseline)
+    if missing:
+        for key in missing:
+            print("no baseline for %s, recording this run as its baseline" % key)
+            baseline[key] = results[key]
+        with open(args.baseline, "w") as baselineFile:
+            json.dump(baseline, baselineFile, indent=2, sort_keys=True)
+        print("NOTICE baseline for %d points written to %s, commit it to keep it" % (len(missing), args.baseline))
+
+    regressions = compare(results, baseline, args.tolerance)
+    for regression in regressions:
+        print("REGRESSION %s" % regression)
+    if regressions:
+        sys.exit(1)
+    print("no regressions against %s" % args.baseline)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,60 @@
+"""Scalable model used by the benchmark harness.
+
+Run with sst, passing the sweep point as model options, for example:
+    sst --model-options="--users 1000 --cacheBytes 131072 --policy lru" tests/benchmarkModel.py
+
+With --population the users are simulated by a single userPopulation
+component instead of one websiteUser component each.
+"""
+import argparse
+
+import sst
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--users", type=int, default=10)
+parser.add_argument("--cacheBytes", type=int, default=131072)
+parser.add_argument("--policy", default="lru")
+parser.add_argument("--population", action="store_true")
+args = parser.parse_args()
+
+websiteCache = sst.Component("websiteCache", "thunderingHerd.websiteCache")
+websiteCache.addParams(
+    {
+        "randomseed": "151515",
+        "numUsers": 1 if args.population else args.users,
+        "maxCacheBytes": args.cacheBytes,
+        "cachePolicy": args.policy,
+        "verbose": 1,  # only the end of simulation summary
+    }
+)
+
+websiteServer = sst.Component("websiteServer", "thunderingHerd.websiteServer")
+websiteServer.addParams({"randomseed": "151515", "verbose": 1})
+
+sst.Link("Server_Cache_Link").connect(
+    (websiteServer, "websiteCache", "1ps"), (websiteCache, "websiteServer", "1ps")
+)
+
+userParams = {
+    "websiteBrowsingLength": "10s",
+    "websiteRefreshLength": "2s",
+    "requestTimeoutLength": "5",
+    "verbose": 1,
+}
+
+if args.population:
+    # every user shares the single user1 port of the cache
+    population = sst.Component("userPopulation", "thunderingHerd.userPopulation")
+    population.addParams(dict(userParams, numUsers=args.users, firstUserId=1))
+    sst.Link("User_Link_1").connect((population, "websiteCache", "1ps"), (websiteCache, "user1", "1ps"))
+    userIDs = []
+else:
+    userIDs = range(1, args.users + 1)
+
+# same user behaviour as tests/thunderingHerd.py, repeated for every user
+for userID in userIDs:
+    user = sst.Component("user%d" % userID, "thunderingHerd.websiteUser")
+    user.addParams(dict(userParams, id=userID))
+    sst.Link("User_Link_%d" % userID).connect(
+        (user, "websiteCache", "1ps"), (websiteCache, "user%d" % userID, "1ps")
+    )
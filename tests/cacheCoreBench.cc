@@ -0,0 +1,84 @@
+/**
+ * Microbenchmark of cacheCore.h, built without SST by make microbench, which
+ * runs tests/cacheCoreTest.cc first.
+ *
+ * Measures ns/op of hits, misses that insert into a cache with free space,
+ * and inserts that evict from a full cache, for both replacement policies
+ * from 1K up to 10M entries (or the size given as the first argument).
+ *
+ */
+
+#include "../cacheCore.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+typedef cacheCore<uint64_t, uint64_t, lruPolicy, countCapacity> lruCache;
+typedef cacheCore<uint64_t, uint64_t, gdsfPolicy, countCapacity> gdsfCache;
+
+// keeps the compiler from removing lookups whose result is unused
+static volatile uint64_t sink;
+
+static double nanosecondsPerOp(std::chrono::steady_clock::time_point start, uint64_t ops) {
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / ops;
+}
+
+template <typename Cache>
+static void runSize(const char *policy, uint32_t entries, const std::vector<uint64_t> &order) {
+    Cache *cache = new Cache(countCapacity(entries));
+    // sizes vary so GDSF priorities differ between entries
+    auto sizeOf = [](uint64_t key) { return 512 + (key * 2654435761ULL) % 65536; };
+
+    // misses that insert, keys 0 to entries - 1 into an empty cache
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t key = 0; key < entries; key++) {
+        if (cache->find(key) == NULL) {
+            cache->insert(key, key, sizeOf(key));
+        }
+    }
+    double missInsert = nanosecondsPerOp(start, entries);
+
+    // hits on random keys, all of which are cached
+    uint64_t hitOps = std::max<uint64_t>(entries, 1000000);
+    uint64_t total = 0;
+    start = std::chrono::steady_clock::now();
+    for (uint64_t op = 0; op < hitOps; op++) {
+        total += *cache->find(order[op % order.size()] % entries);
+    }
+    double hit = nanosecondsPerOp(start, hitOps);
+    sink = total;
+
+    // misses on new keys into the full cache, each one evicts an entry
+    start = std::chrono::steady_clock::now();
+    for (uint64_t key = entries; key < 2 * (uint64_t)entries; key++) {
+        if (cache->find(key) == NULL) {
+            cache->insert(key, key, sizeOf(key));
+        }
+    }
+    double evict = nanosecondsPerOp(start, entries);
+
+    printf("%-6s %10u %12.1f %12.1f %12.1f\n", policy, entries, hit, missInsert, evict);
+    fflush(stdout);
+    delete cache;
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t maxEntries = argc > 1 ? std::strtoull(argv[1], NULL, 10) : 10000000;
+
+    // random access order, generated before timing starts
+    std::mt19937_64 rng(151515);
+    std::vector<uint64_t> order(1 << 20);
+    for (uint64_t &key : order) {
+        key = rng();
+    }
+
+    printf("%-6s %10s %12s %12s %12s\n", "policy", "entries", "hit ns/op", "insert ns/op", "evict ns/op");
+    for (uint64_t entries = 1000; entries <= maxEntries; entries *= 10) {
+        runSize<lruCache>("lru", entries, order);
+        runSize<gdsfCache>("gdsf", entries, order);
+    }
+    return 0;
+}
@@ -0,0 +1,140 @@
+/**
+ * Correctness test of cacheCore.h, built and run by make microbench before
+ * the benchmark.
+ *
+ * Runs random finds, inserts and erases against reference models, LRU as a
+ * std::map plus a std::list in recency order and GDSF as a linear scan for
+ * the lowest priority, checking every result along with size() and
+ * usedCapacity(). Ties in GDSF priority may be broken either way, so an
+ * eviction only has to pick one of the lowest priority entries.
+ *
+ */
+
+#include "../cacheCore.h"
+#include <cstdio>
+#include <list>
+#include <map>
+#include <random>
+#include <string>
+
+static int failures = 0;
+
+static void check(bool condition, const char *policy, int op, const char *what) {
+    if (!condition && failures++ < 10) {
+        printf("FAIL %s op %d: %s\n", policy, op, what);
+    }
+}
+
+// reference entry, the LRU model keeps its place in the recency list
+struct referenceEntry {
+    uint64_t value;
+    uint64_t size;
+    uint64_t hits;
+    double priority;
+    std::list<std::string>::iterator recency;
+};
+
+template <typename Policy>
+static void runTest(const char *policy, bool gdsf, uint32_t seed) {
+    const uint64_t maxBytes = 5000;
+    const uint32_t maxEntries = 40;
+    cacheCore<std::string, uint64_t, Policy, byteCapacity> cache(byteCapacity(maxBytes, maxEntries));
+
+    std::map<std::string, referenceEntry> reference;
+    std::list<std::string> recency;    // most recently used first
+    uint64_t used = 0;
+    double inflation = 0;
+    std::mt19937 rng(seed);
+
+    // removes an entry from the reference model
+    auto remove = [&](const std::string &key) {
+        used -= reference[key].size;
+        recency.erase(reference[key].recency);
+        reference.erase(key);
+    };
+
+    for (int op = 0; op < 200000; op++) {
+        std::string key = "page" + std::to_string(rng() % 120);
+        uint32_t action = rng() % 10;
+
+        if (action < 6) {
+            // find, which counts as a use
+            uint64_t *value = cache.find(key);
+            auto it = reference.find(key);
+            check((value != NULL) == (it != reference.end()), policy, op, "find hit or miss");
+            if (value != NULL && it != reference.end()) {
+                check(*value == it->second.value, policy, op, "find value");
+                it->second.hits++;
+                it->second.priority = inflation + (double)it->second.hits / it->second.size;
+                recency.splice(recency.begin(), recency, it->second.recency);
+            }
+        } else if (action < 9) {
+            // insert or replace, checking each eviction the cache makes
+            uint64_t size = 1 + rng() % 1500;
+            uint64_t value = rng();
+            if (reference.count(key)) {
+                remove(key);
+            }
+            uint64_t usedBeforeEvict = used;
+            size_t entriesBeforeEvict = reference.size();
+            int evictions = 0;
+            cache.insert(key, value, size, [&](const std::string &victim, const uint64_t &victimValue) {
+                check(reference.count(victim) == 1, policy, op, "evicted key is cached");
+                if (reference.count(victim) == 0) {
+                    return;
+                }
+                if (gdsf) {
+                    double lowest = reference.begin()->second.priority;
+                    for (auto &entry : reference) {
+                        lowest = std::min(lowest, entry.second.priority);
+                    }
+                    check(reference[victim].priority == lowest, policy, op, "evicted the lowest priority");
+                    inflation = reference[victim].priority;
+                } else {
+                    check(victim == recency.back(), policy, op, "evicted the least recently used");
+                }
+                check(victimValue == reference[victim].value, policy, op, "evicted value");
+                usedBeforeEvict = used;
+                entriesBeforeEvict = reference.size();
+                remove(victim);
+                evictions++;
+            });
+            // the last eviction has to have been needed to make room
+            if (evictions > 0) {
+                check(usedBeforeEvict + size > maxBytes || entriesBeforeEvict >= maxEntries, policy, op, "evicted more than needed");
+            }
+            recency.push_front(key);
+            reference[key] = { value, size, 1, inflation + 1.0 / size, recency.begin() };
+            used += size;
+        } else {
+            bool erased = cache.erase(key);
+            check(erased == (reference.count(key) == 1), policy, op, "erase");
+            if (reference.count(key)) {
+                remove(key);
+            }
+        }
+
+        check(cache.size() == reference.size(), policy, op, "size()");
+        check(cache.usedCapacity() == used, policy, op, "usedCapacity()");
+        check(used <= maxBytes && reference.size() <= maxEntries, policy, op, "within capacity");
+    }
+
+    // every cached entry is visited once
+    size_t visited = 0;
+    cache.forEach([&](const std::string &key, const uint64_t &value) {
+        check(reference.count(key) == 1 && reference[key].value == value, policy, 0, "forEach entry");
+        visited++;
+    });
+    check(visited == reference.size(), policy, 0, "forEach count");
+}
+
+int main() {
+    runTest<lruPolicy>("lru", false, 1);
+    runTest<gdsfPolicy>("gdsf", true, 2);
+    if (failures > 0) {
+        printf("%d checks failed\n", failures);
+        return 1;
+    }
+    printf("cacheCore passed\n");
+    return 0;
+}
@@ -25,32 +25,37 @@ userFive.addParams({"websiteBrowsingLength": "10s", "websiteRefreshLength": "2s"
 websiteCache = sst.Component("websiteCache", "thunderingHerd.websiteCache")
 websiteCache.addParams(
     {
-        "randomseed": "151515"  # random seed
+        "randomseed": "151515",  # random seed
+        "numUsers": "5",  # users connect to ports user1 through user5
+        "maxCacheBytes": "131072",  # cache capacity in bytes
+        "cachePolicy": "lru",  # lru, or gdsf for size aware replacement
+        "linkBandwidth": "1GB/s",  # bandwidth of the links to the users
     }
 )
 
 websiteServer = sst.Component("websiteServer", "thunderingHerd.websiteServer")
 websiteServer.addParams(
     {
-        "randomseed": "151515"  # random seed
+        "randomseed": "151515",  # random seed
+        "linkBandwidth": "1GB/s",  # bandwidth of the link to the cache
     }
 )
 
 # Connect the nodes by their ports.
 sst.Link("User_One_Link").connect(
-    (userOne, "websiteCache", "1ps"), (websiteCache, "userOne", "1ps")
+    (userOne, "websiteCache", "1ps"), (websiteCache, "user1", "1ps")
 )
 sst.Link("User_Two_Link").connect(
-    (userTwo, "websiteCache", "1ps"), (websiteCache, "userTwo", "1ps")
+    (userTwo, "websiteCache", "1ps"), (websiteCache, "user2", "1ps")
 )
 sst.Link("User_Three_Link").connect(
-    (userThree, "websiteCache", "1ps"), (websiteCache, "userThree", "1ps")
+    (userThree, "websiteCache", "1ps"), (websiteCache, "user3", "1ps")
 )
 sst.Link("User_Four_Link").connect(
-    (userFour, "websiteCache", "1ps"), (websiteCache, "userFour", "1ps")
+    (userFour, "websiteCache", "1ps"), (websiteCache, "user4", "1ps")
 )
 sst.Link("User_Five_Link").connect(
-    (userFive, "websiteCache", "1ps"), (websiteCache, "userFive", "1ps")
+    (userFive, "websiteCache", "1ps"), (websiteCache, "user5", "1ps")
 )
 sst.Link("Server_Cache_Link").connect(
     (websiteServer, "websiteCache", "1ps"), (websiteCache, "websiteServer", "1ps")
@@ -0,0 +1,90 @@
+"""The scenario of tests/thunderingHerd.py with the optional features on:
+fair queueing, idempotent retries, herd alarms, the circuit breaker, page
+updates with dependency invalidation, samplers and statistics.
+thunderingHerd.py keeps every feature at its default.
+"""
+import sst
+
+userOne = sst.Component("userOne", "thunderingHerd.websiteUser")
+userOne.addParams(
+    {
+        "websiteBrowsingLength": "10s",     # how often to check user status
+        "websiteRefreshLength": "2s",       # how often to spam refresh if your request timed out
+        "requestTimeoutLength": "5",        # how many cycles to wait for a cache response until one becomes impatient
+        "id": "1",                          # id for cache to identify user
+    }
+)
+
+userTwo = sst.Component("userTwo", "thunderingHerd.websiteUser")
+userTwo.addParams({"websiteBrowsingLength": "10s", "websiteRefreshLength": "2s", "requestTimeoutLength": "5", "id": "2"})
+
+userThree = sst.Component("userThree", "thunderingHerd.websiteUser")
+userThree.addParams({"websiteBrowsingLength": "10s", "websiteRefreshLength": "2s", "requestTimeoutLength": "5", "id": "3"})
+
+userFour = sst.Component("userFour", "thunderingHerd.websiteUser")
+userFour.addParams({"websiteBrowsingLength": "10s", "websiteRefreshLength": "2s", "requestTimeoutLength": "5", "id": "4"})
+
+userFive = sst.Component("userFive", "thunderingHerd.websiteUser")
+userFive.addParams({"websiteBrowsingLength": "10s", "websiteRefreshLength": "2s", "requestTimeoutLength": "5", "id": "5"})
+
+websiteCache = sst.Component("websiteCache", "thunderingHerd.websiteCache")
+websiteCache.addParams(
+    {
+        "randomseed": "151515",  # random seed
+        "numUsers": "5",  # users connect to ports user1 through user5
+        "maxCacheBytes": "131072",  # cache capacity in bytes
+        "cachePolicy": "lru",  # lru, or gdsf for size aware replacement
+        "queuePolicy": "fair",  # fifo, or fair to share the cache between first requests and retries
+        "idempotentRetries": "true",  # merge retries and drop superseded requests
+        "linkBandwidth": "1GB/s",  # bandwidth of the links to the users
+        "metricWindow": "60s",  # sliding window for herd detection metrics
+        "duplicateMissAlarm": "3",  # misses for a page already in flight
+        "retryRatioAlarm": "1.0",  # retries per first request
+        "circuitBreaker": "true",  # stop forwarding misses to a struggling server
+        "breakerSlowCall": "20s",  # server responses slower than this count as failures
+        "invalidationPolicy": "delete",  # delete, or refresh to keep serving the old page
+    }
+)
+
+websiteServer = sst.Component("websiteServer", "thunderingHerd.websiteServer")
+websiteServer.addParams(
+    {
+        "randomseed": "151515",  # random seed
+        "linkBandwidth": "1GB/s",  # bandwidth of the link to the cache
+        "idempotentRetries": "true",  # drop requests a user's newer request replaced
+        "updateInterval": "60s",  # how often a page is updated, 0s never updates
+        "invalidationMode": "dependency",  # dependency, or broadcast to invalidate every page
+        "pageDependencies": "[login:settings, login:profile1]",  # pages invalidated with login
+    }
+)
+
+# Record queue depths and cache occupancy over time, written to samples-*.csv
+cacheSampler = websiteCache.setSubComponent("sampler", "thunderingHerd.timeSeriesSampler")
+cacheSampler.addParams({"sampleInterval": "1s", "filePrefix": "samples"})
+serverSampler = websiteServer.setSubComponent("sampler", "thunderingHerd.timeSeriesSampler")
+serverSampler.addParams({"sampleInterval": "1s", "filePrefix": "samples"})
+
+# Print the circuit breaker transition counts at the end of the simulation
+sst.setStatisticLoadLevel(1)
+sst.setStatisticOutput("sst.statOutputConsole")
+websiteCache.enableAllStatistics()
+
+# Connect the nodes by their ports.
+sst.Link("User_One_Link").connect(
+    (userOne, "websiteCache", "1ps"), (websiteCache, "user1", "1ps")
+)
+sst.Link("User_Two_Link").connect(
+    (userTwo, "websiteCache", "1ps"), (websiteCache, "user2", "1ps")
+)
+sst.Link("User_Three_Link").connect(
+    (userThree, "websiteCache", "1ps"), (websiteCache, "user3", "1ps")
+)
+sst.Link("User_Four_Link").connect(
+    (userFour, "websiteCache", "1ps"), (websiteCache, "user4", "1ps")
+)
+sst.Link("User_Five_Link").connect(
+    (userFive, "websiteCache", "1ps"), (websiteCache, "user5", "1ps")
+)
+sst.Link("Server_Cache_Link").connect(
+    (websiteServer, "websiteCache", "1ps"), (websiteCache, "websiteServer", "1ps")
+)
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include <sst/core/sst_config.h>
+#include "timeSeriesSampler.h"
+#include <algorithm>
+
+timeSeriesSampler::timeSeriesSampler( SST::ComponentId_t id, SST::Params& params ) : SST::SubComponent(id) {
+
+    // initalizes the name of the sampler for our output
+    output.init("timeSeriesSampler-" + getName() + "-> ", 1, 0, SST::Output::STDOUT);
+
+    // This grabs the parameters that were defined in the python test file in
+    // order to initalize our subcomponent
+    std::string sampleInterval = params.find<std::string>("sampleInterval", "1s");
+    bufferSamples = std::max<size_t>(params.find<size_t>("bufferSamples", 4096), 1);
+    std::string format = params.find<std::string>("format", "csv");
+    if (format != "csv" && format != "binary") {
+        output.fatal(CALL_INFO, -1, "Unknown 'format' %s, expected csv or binary\n", format.c_str());
+    }
+    binaryFormat = (format == "binary");
+
+    // subcomponent names look like "parent:slot[0]", which is not a nice filename
+    std::string name = getName();
+    std::replace_if(name.begin(), name.end(), [](char c) { return !isalnum(c); }, '_');
+    filename = params.find<std::string>("filePrefix", "samples") + "-" + name + (binaryFormat ? ".bin" : ".csv");
+    file = NULL;
+    bufferUsed = 0;
+
+    registerClock(sampleInterval, new SST::Clock::Handler<timeSeriesSampler>(this, &timeSeriesSampler::sampleTick));
+}
+
+timeSeriesSampler::~timeSeriesSampler() {
+    if (writer.joinable()) {
+        writer.join();
+    }
+    if (file != NULL) {
+        fclose(file);
+    }
+}
+
+void timeSeriesSampler::addProbe(const std::string &name, std::function<double()> probe) {
+    probeNames.push_back(name);
+    probes.push_back(probe);
+}
+
+void timeSeriesSampler::setup() {
+    if (file != NULL) {
+        return;
+    }
+    // every row holds the sim time followed by one value per probe, both
+    // buffers are allocated up front so sampling never allocates
+    activeBuffer.resize(bufferSamples * (probes.size() + 1));
+    writeBuffer.resize(activeBuffer.size());
+
+    file = fopen(filename.c_str(), binaryFormat ? "wb" : "w");
+    if (file == NULL) {
+        output.fatal(CALL_INFO, -1, "Failed to open sample file %s\n", filename.c_str());
+    }
+
+    // both formats start with a csv header line naming the columns
+    fprintf(file, "time_ns");
+    for (const std::string &name : probeNames) {
+        fprintf(file, ",%s", name.c_str());
+    }
+    fprintf(file, "\n");
+}
+
+void timeSeriesSampler::finish() {
+    if (file == NULL) {
+        return;
+    }
+    flush();
+    if (writer.joinable()) {
+        writer.join();
+    }
+}
+
+bool timeSeriesSampler::sampleTick( SST::Cycle_t currentCycle ) {
+    // nothing to record into until the parent has called setup
+    if (activeBuffer.empty()) {
+        return false;
+    }
+    activeBuffer[bufferUsed++] = (double)getCurrentSimTimeNano();
+    for (auto &probe : probes) {
+        activeBuffer[bufferUsed++] = probe();
+    }
+    if (bufferUsed == activeBuffer.size()) {
+        flush();
+    }
+    return false;
+}
+
+void timeSeriesSampler::flush() {
+    if (bufferUsed == 0) {
+        return;
+    }
+    // the previous write has to finish before its buffer can be reused
+    if (writer.joinable()) {
+        writer.join();
+    }
+    std::swap(activeBuffer, writeBuffer);
+    size_t numValues = bufferUsed;
+    bufferUsed = 0;
+    writer = std::thread(&timeSeriesSampler::writeSamples, this, std::cref(writeBuffer), numValues);
+}
+
+void timeSeriesSampler::writeSamples(const std::vector<double> &samples, size_t numValues) {
+    if (binaryFormat) {
+        fwrite(samples.data(), sizeof(double), numValues, file);
+        return;
+    }
+    size_t rowLength = probes.size() + 1;
+    for (size_t i = 0; i < numValues; i += rowLength) {
+        fprintf(file, "%.0f", samples[i]);
+        for (size_t j = 1; j < rowLength; j++) {
+            fprintf(file, ",%g", samples[i + j]);
+        }
+        fprintf(file, "\n");
+    }
+}
@@ -0,0 +1,125 @@
+#ifndef _timeSeriesSampler_H
+#define _timeSeriesSampler_H
+
+#include <sst/core/subcomponent.h>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file timeSeriesSampler.h
+ * @brief This creates a monitor subcomponent that samples values from the
+ * component it is loaded into (queue depths, cache occupancy, user states)
+ * at a fixed sim-time interval, so herd onset can be seen over time instead
+ * of only as end of run totals
+ *
+ */
+
+class timeSeriesSampler : public SST::SubComponent {
+
+public:
+	/**
+	 * \cond
+	 */
+	SST_ELI_REGISTER_SUBCOMPONENT_API(timeSeriesSampler)
+
+	SST_ELI_REGISTER_SUBCOMPONENT(
+		timeSeriesSampler, // class
+		"thunderingHerd", // element library
+		"timeSeriesSampler", // subcomponent
+		SST_ELI_ELEMENT_VERSION( 1, 0, 0 ),
+		"samples values from its parent component into a ring buffer and writes them to a file",
+		timeSeriesSampler // api
+	)
+
+	// Parameter name, description, default value
+	SST_ELI_DOCUMENT_PARAMS(
+		{ "sampleInterval", "Sim time between samples", "1s" },
+		{ "bufferSamples", "Number of samples held in memory before they are written out", "4096" },
+		{ "filePrefix", "Prefix of the output file, the subcomponent name is appended", "samples" },
+		{ "format", "Output format, either csv or binary (raw doubles after a csv header line)", "csv" },
+	)
+	/**
+	 * \endcond
+	 */
+
+	/**
+	 * @brief Construct a new time series sampler
+	 *
+	 * @param id The id for the subcomponent, this is passed in by SST
+	 * @param params The params set by the project driver
+	 */
+	timeSeriesSampler( SST::ComponentId_t id, SST::Params& params );
+
+	/**
+	 * @brief Destroy the time series sampler, waiting on any pending write
+	 *
+	 */
+	~timeSeriesSampler();
+
+	/**
+	 * @brief Adds a value to be sampled, the parent calls this while it is
+	 * being constructed
+	 *
+	 * @param name Column name in the output file
+	 * @param probe Function returning the current value
+	 */
+	void addProbe(const std::string &name, std::function<double()> probe);
+
+	/**
+	 * @brief Allocates the sample buffers now that every probe is known, and
+	 * opens the output file. SST does not call this on subcomponents, so the
+	 * parent calls it from its own setup.
+	 *
+	 */
+	void setup();
+
+	/**
+	 * @brief Writes out the samples still held in memory, called from the
+	 * parent's finish
+	 *
+	 */
+	void finish();
+
+	/**
+	 * @brief Records the current value of every probe, once setup has
+	 * allocated the buffers
+	 *
+	 * @param currentCycle This tells us what cycle of the simulation we're on
+	 * @return This returns whether or not the clock should be removed
+	 */
+	bool sampleTick( SST::Cycle_t currentCycle );
+
+private:
+	/**
+	 * @brief Hands the full buffer to a background thread to write, and
+	 * continues sampling into the other buffer
+	 *
+	 */
+	void flush();
+
+	/**
+	 * @brief Writes a block of samples to the output file, run on the
+	 * writer thread
+	 *
+	 */
+	void writeSamples(const std::vector<double> &samples, size_t numValues);
+
+	SST::Output output;
+	std::vector<std::string> probeNames;			/* column names */
+	std::vector<std::function<double()>> probes;	/* functions read every sample */
+
+	size_t bufferSamples;			/* rows held per buffer */
+	std::vector<double> activeBuffer;	/* buffer samples are written into */
+	std::vector<double> writeBuffer;	/* buffer being written out by the writer thread */
+	size_t bufferUsed;				/* values stored in the active buffer */
+
+	std::string filename;
+	bool binaryFormat;
+	FILE *file;
+	std::thread writer;				/* background writer for the previous buffer */
+};
+
+#endif
@@ -0,0 +1,206 @@
+/**
+ * Model of many users trying to access a website, simulated together so
+ * large herds can be built without one component per user
+ *
+ */
+
+#include <sst/core/sst_config.h>
+#include <sst/core/interfaces/stringEvent.h>
+#include <sst/core/stopAction.h>
+#include <sst/core/simulation.h>
+#include "userPopulation.h"
+#include <limits>
+
+userPopulation::userPopulation( SST::ComponentId_t id, SST::Params& params ) : SST::Component(id) {
+
+    // per user messages are only printed with verbose set to 2 or higher,
+    // since a population can hold millions of users
+    output.init("userPopulation-" + getName() + "-> ", params.find<uint32_t>("verbose", 1), 0, SST::Output::STDOUT);
+
+    // This grabs the parameters that were defined in the python test file in
+    // order to initalize our component
+    numUsers = params.find<uint32_t>("numUsers", 1000);
+    firstUserId = params.find<int64_t>("firstUserId", 1);
+    requestTimeoutLength = params.find<int64_t>("requestTimeoutLength", 5);
+    SST::UnitAlgebra browsingLength = params.find<SST::UnitAlgebra>("websiteBrowsingLength", "10s");
+    SST::UnitAlgebra refreshLength = params.find<SST::UnitAlgebra>("websiteRefreshLength", "2s");
+    if ( !browsingLength.hasUnits("s") || !refreshLength.hasUnits("s") ) {
+        output.fatal(CALL_INFO, -1, "Parameters 'websiteBrowsingLength' and 'websiteRefreshLength' must be times\n");
+    }
+    browsingPeriod = (SST::SimTime_t)(browsingLength.getDoubleValue() * 1e9);
+    refreshPeriod = (SST::SimTime_t)(refreshLength.getDoubleValue() * 1e9);
+    if ( browsingPeriod == 0 || refreshPeriod == 0 ) {
+        output.fatal(CALL_INFO, -1, "Browsing and refresh lengths must be at least 1ns\n");
+    }
+    rng = new SST::RNG::MarsagliaRNG(15, params.find<uint32_t>("randomseed", 151515));
+
+    // same pages a websiteUser knows about
+    listOfPages = {"home", "login", "profile1", "profile2", "profile3", "profile4", "settings", "about"};
+
+    // every user starts out requesting, like websiteUser
+    status.assign(numUsers, REQUESTING);
+    currentWebsiteRequest.assign(numUsers, 0);
+    startWaitingCycle.assign(numUsers, 0);
+    retryCount.assign(numUsers, 0);
+    sequence.assign(numUsers, 0);
+    nextAction.assign(numUsers, std::numeric_limits<SST::SimTime_t>::max());
+    statusCounts[BROWSING] = 0;
+    statusCounts[REFRESHING] = 0;
+    statusCounts[REQUESTING] = numUsers;
+    statusCounts[WAITING] = 0;
+    pendingWakeup = std::numeric_limits<SST::SimTime_t>::max();
+
+    // register as a primary component, so the simulation keeps running while
+    // the users are active, the same as websiteUser
+    registerAsPrimaryComponent();
+    primaryComponentDoNotEndSim();
+
+    // load the optional sampler, which records how many users are in each state
+    sampler = loadUserSubComponent<timeSeriesSampler>("sampler");
+    if ( sampler ) {
+        sampler->addProbe("browsing", [this]() { return (double)statusCounts[BROWSING]; });
+        sampler->addProbe("refreshing", [this]() { return (double)statusCounts[REFRESHING]; });
+        sampler->addProbe("requesting", [this]() { return (double)statusCounts[REQUESTING]; });
+        sampler->addProbe("waiting", [this]() { return (double)statusCounts[WAITING]; });
+    }
+
+    // Configure our port to the cache, and a self link which replaces the
+    // per user clocks with one wakeup for whichever user is due next
+    websiteCache = configureLink("websiteCache", "1ns", new SST::Event::Handler<userPopulation>(this, &userPopulation::handleEvent));
+    if ( !websiteCache ) {
+        output.fatal(CALL_INFO, -1, "Failed to configure port 'websiteCache'\n");
+    }
+    selfLink = configureSelfLink("wakeup", "1ns", new SST::Event::Handler<userPopulation>(this, &userPopulation::wakeup));
+}
+
+userPopulation::~userPopulation() {
+    delete rng;
+}
+
+void userPopulation::setup() {
+    // SST only sets up components, so the sampler is set up from here
+    if ( sampler ) {
+        sampler->setup();
+    }
+
+    // randomize grab of first website, and request it from the cache
+    for (uint32_t user = 0; user < numUsers; user++) {
+        currentWebsiteRequest[user] = rng->generateNextUInt32() % listOfPages.size();
+        retryCount[user] = 0;
+        sequence[user]++;
+        sendRequest(user);
+        scheduleUser(user);
+    }
+    output.output(CALL_INFO, "%u users sent their first request \n", numUsers);
+}
+
+void userPopulation::finish() {
+    if ( sampler ) {
+        sampler->finish();
+    }
+}
+
+void userPopulation::wakeup(SST::Event *ev) {
+    delete ev;
+    SST::SimTime_t now = getCurrentSimTimeNano();
+    if (now >= pendingWakeup) {
+        pendingWakeup = std::numeric_limits<SST::SimTime_t>::max();
+    }
+
+    // run every user who is due, skipping entries that were rescheduled
+    while (!actions.empty() && actions.top().first <= now) {
+        userAction action = actions.top();
+        actions.pop();
+        if (nextAction[action.second] == action.first) {
+            runUser(action.second);
+        }
+    }
+
+    // sleep until the next user is due
+    if (!actions.empty() && actions.top().first < pendingWakeup) {
+        pendingWakeup = actions.top().first;
+        selfLink->send(pendingWakeup - now, new SST::Interfaces::StringEvent("wakeup"));
+    }
+}
+
+void userPopulation::runUser(uint32_t user) {
+    SST::SimTime_t now = getCurrentSimTimeNano();
+    if (status[user] == BROWSING) {
+        // browse for one cycle, then request on the next
+        setStatus(user, REQUESTING);
+    } else if (status[user] == REQUESTING) {
+        // done browsing, needs a new site to look at
+        currentWebsiteRequest[user] = rng->generateNextUInt32() % listOfPages.size();
+        retryCount[user] = 0;
+        sequence[user]++;
+        sendRequest(user);
+        setStatus(user, WAITING);
+        startWaitingCycle[user] = now / browsingPeriod;
+    } else if (status[user] == WAITING) {
+        // being impatient, send another request for same website
+        retryCount[user]++;
+        sendRequest(user);
+    }
+    scheduleUser(user);
+}
+
+void userPopulation::sendRequest(uint32_t user) {
+    std::string pageRequest = listOfPages.at(currentWebsiteRequest[user]);
+    output.verbose(CALL_INFO, 2, 0, "user %ld is now requesting %s \n", firstUserId + user, pageRequest.c_str());
+    struct CacheRequest cachereq = { USER, firstUserId + user, pageRequest, "", 0, 0, retryCount[user], sequence[user] };
+    websiteCache->send(new CacheRequestEvent(cachereq));
+}
+
+void userPopulation::setStatus(uint32_t user, userStatus newStatus) {
+    statusCounts[status[user]]--;
+    statusCounts[newStatus]++;
+    status[user] = newStatus;
+}
+
+void userPopulation::scheduleUser(uint32_t user) {
+    SST::SimTime_t now = getCurrentSimTimeNano();
+    SST::SimTime_t next;
+    if (status[user] == WAITING) {
+        // websiteUser::waitingTick compares its refresh clock cycle against
+        // the browsing clock cycle the user started waiting on, so the user
+        // re-requests on every refresh cycle past that point
+        SST::Cycle_t cycle = std::max<SST::Cycle_t>(now / refreshPeriod + 1, startWaitingCycle[user] + requestTimeoutLength + 1);
+        next = cycle * refreshPeriod;
+    } else {
+        // browsing and requesting users act on the next browsing clock cycle
+        next = (now / browsingPeriod + 1) * browsingPeriod;
+    }
+
+    // the user is already queued for this time
+    if (next == nextAction[user]) {
+        return;
+    }
+    nextAction[user] = next;
+    actions.push(userAction(next, user));
+
+    // a reply can make a user due earlier than the wakeup we are waiting on
+    if (next < pendingWakeup) {
+        pendingWakeup = next;
+        selfLink->send(next - now, new SST::Interfaces::StringEvent("wakeup"));
+    }
+}
+
+void userPopulation::handleEvent(SST::Event *ev) {
+    UserRequestEvent *userev = dynamic_cast<UserRequestEvent*>(ev);
+    if ( userev != NULL ) {
+        int64_t user = userev->userreq.userID - firstUserId;
+        if (user < 0 || user >= numUsers) {
+            output.fatal(CALL_INFO, -1, "Recieved a reply for user %ld, who is not in this population\n", userev->userreq.userID);
+        }
+        if (userev->userreq.validSite) {
+            // recieved a valid website from the cache, can start browsing
+            setStatus(user, BROWSING);
+        } else {
+            // did not get a response from cache
+            // impatient, so we will refresh after waiting for refresh time
+            setStatus(user, WAITING);
+        }
+        scheduleUser(user);
+    }
+    delete ev;
+}
@@ -0,0 +1,166 @@
+#ifndef _userPopulation_H
+#define _userPopulation_H
+
+#include <sst/core/component.h>
+#include <sst/core/link.h>
+#include <sst/core/rng/marsaglia.h>
+#include <sst/core/event.h>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+#include "requests.h"
+#include "timeSeriesSampler.h"
+
+/**
+ * @file userPopulation.h
+ * @brief This creates a component that simulates many website users at once,
+ * following the same browsing, requesting and waiting behavior as
+ * websiteUser, but storing each user's state in shared arrays so large herds
+ * fit on a single node
+ *
+ */
+
+class userPopulation : public SST::Component {
+
+public:
+	/**
+	 * @brief Construct a new user Population object
+	 *
+	 * @param id The id for the component, this is passed in by SST. Usually
+	 * just need to pass it to the base SST::Component constructor
+	 * @param params The params set by the project driver
+	 */
+	userPopulation( SST::ComponentId_t id, SST::Params& params );
+
+	/**
+	 * @brief Destroy the user Population object
+	 *
+	 */
+	~userPopulation();
+
+	/**
+	 * @brief Every user requests a random first website, the same as
+	 * websiteUser::setup
+	 *
+	 */
+	void setup();
+
+	/**
+	 * @brief Writes out the sampler's remaining samples, if one was loaded
+	 *
+	 */
+	void finish();
+
+	/**
+	 * @brief Runs every user whose next action is due, then schedules a
+	 * wakeup for the next due user
+	 *
+	 * @param ev The wakeup event sent over the self link
+	 */
+	void wakeup(SST::Event *ev);
+
+	/**
+	 * @brief handles messages sent back from the cache to one of the users,
+	 * using the id in the reply to find which one
+	 *
+	 * @param ev An event object that holds the contents of the message
+	 * sent back from the cache
+	 */
+	void handleEvent(SST::Event *ev);
+
+	/**
+	 * \cond
+	 */
+	// Register the component
+	SST_ELI_REGISTER_COMPONENT(
+		userPopulation, // class
+		"thunderingHerd", // element library
+		"userPopulation", // component
+		SST_ELI_ELEMENT_VERSION( 1, 0, 0 ),
+		"many users who browse various pages on a website, simulated in one component",
+		COMPONENT_CATEGORY_UNCATEGORIZED
+	)
+
+	// Parameter name, description, default value
+	SST_ELI_DOCUMENT_PARAMS(
+		{ "numUsers", "How many users to simulate", "1000" },
+		{ "firstUserId", "id of the first user, the others follow consecutively", "1" },
+		{ "websiteBrowsingLength", "How long to wait between checking user status", "10s" },
+		{ "websiteRefreshLength", "How long to wait between impatiently waiting for a website", "2s" },
+		{ "requestTimeoutLength", "How many cycles to wait for a cache response", "5" },
+		{ "randomseed", "Random Seed for the pages users request", "151515" },
+		{ "verbose", "Output verbosity, 2 prints every request", "1" },
+	)
+
+	// Port name, description, event type
+	SST_ELI_DOCUMENT_PORTS(
+		{ "websiteCache", "Connecting port to the website cache", {"sst.Interfaces.StringEvent"}},
+	)
+
+	// Subcomponent slot name, description, interface
+	SST_ELI_DOCUMENT_SUBCOMPONENT_SLOTS(
+		{ "sampler", "Optional sampler recording how many users are in each state over time", "timeSeriesSampler" },
+	)
+	/**
+	 * \endcond
+	 */
+
+private:
+	/**
+	 * @brief Runs one user's clock behavior at the current time, the same
+	 * as websiteUser::clockTick and websiteUser::waitingTick
+	 *
+	 * @param user Index of the user in the arrays
+	 */
+	void runUser(uint32_t user);
+
+	/**
+	 * @brief Sends a request for the user's current page to the cache
+	 *
+	 * @param user Index of the user in the arrays
+	 */
+	void sendRequest(uint32_t user);
+
+	/**
+	 * @brief Moves a user to a new status, keeping the status counts current
+	 *
+	 */
+	void setStatus(uint32_t user, userStatus status);
+
+	/**
+	 * @brief Queues the next time a user has to act, based on their status
+	 *
+	 */
+	void scheduleUser(uint32_t user);
+
+	SST::Output output;						/* Standard output to the terminal */
+	SST::RNG::MarsagliaRNG* rng;			/* Random number generator for page requests */
+	SST::Link *websiteCache;				/* Link to the cache, shared by every user */
+	SST::Link *selfLink;					/* Link used to wake up when the next user is due */
+	timeSeriesSampler *sampler;				/* optional sampler, NULL if not loaded */
+
+	uint32_t numUsers;
+	int64_t firstUserId;					/* id for cache of the user at index 0 */
+	SST::SimTime_t browsingPeriod;			/* websiteBrowsingLength in ns */
+	SST::SimTime_t refreshPeriod;			/* websiteRefreshLength in ns */
+	SST::Cycle_t requestTimeoutLength;		/* how many cycles a user will wait for a response until becoming impatient */
+	std::vector<std::string> listOfPages;	/* names of websites a user can request */
+
+	// per user state, indexed by user
+	std::vector<uint8_t> status;				/* userStatus of each user */
+	std::vector<uint8_t> currentWebsiteRequest;	/* spot in listOfPages of each user's request */
+	std::vector<SST::Cycle_t> startWaitingCycle;	/* when each user started waiting for a response */
+	std::vector<int> retryCount;				/* times each user re-sent its current request */
+	std::vector<uint64_t> sequence;				/* number of each user's current request, kept on retries */
+	std::vector<SST::SimTime_t> nextAction;		/* time each user is next due, matches its queue entry */
+	uint64_t statusCounts[4];					/* number of users in each userStatus */
+	SST::SimTime_t pendingWakeup;				/* earliest wakeup already sent on the self link */
+
+	// next action time of every user, entries whose time no longer matches
+	// nextAction are stale and skipped
+	typedef std::pair<SST::SimTime_t, uint32_t> userAction;
+	std::priority_queue<userAction, std::vector<userAction>, std::greater<userAction>> actions;
+};
+
+#endif
@@ -3,16 +3,126 @@
 #include <sst/core/stopAction.h>
 #include <sst/core/simulation.h>
 #include "websiteCache.h"
+#include <algorithm>
 
 websiteCache::websiteCache( SST::ComponentId_t id, SST::Params& params ) : SST::Component(id) {
 
-    // initalizes the name of the cache for our output
-    output.init("websiteCache-" + getName() + "-> ", 1, 0, SST::Output::STDOUT);
+    // initalizes the name of the cache for our output, per request messages 
+    // are only printed with verbose set to 2 or higher
+    output.init("websiteCache-" + getName() + "-> ", params.find<uint32_t>("verbose", 2), 0, SST::Output::STDOUT);
     
     // This grabs the parameters that were defined in the python test file in 
     // order to initalize our component
 	websiteBrowsingLength = params.find<std::string>("websiteBrowsingLength", "10ms");
-    maxCacheSize = params.find<int64_t>("maxCacheSize", 6);
+    maxCacheBytes = params.find<uint64_t>("maxCacheBytes", 131072);
+    cachePolicy = params.find<std::string>("cachePolicy", "lru");
+    if (cachePolicy != "lru" && cachePolicy != "gdsf") {
+        output.fatal(CALL_INFO, -1, "Unknown 'cachePolicy' %s, expected lru or gdsf\n", cachePolicy.c_str());
+    }
+    SST::UnitAlgebra bandwidth = params.find<SST::UnitAlgebra>("linkBandwidth", "1GB/s");
+    if ( !bandwidth.hasUnits("B/s") || bandwidth.getDoubleValue() <= 0 ) {
+        output.fatal(CALL_INFO, -1, "Parameter 'linkBandwidth' must be a positive rate in B/s\n");
+    }
+    linkBandwidth = bandwidth.getDoubleValue();
+
+    // the cache core allocates room for its entries up front, so the number 
+    // of pages is bounded as well as their bytes
+    uint32_t cacheEntries = params.find<uint32_t>("cacheEntries", 1024);
+    if (cacheEntries == 0) {
+        output.fatal(CALL_INFO, -1, "Parameter 'cacheEntries' must be at least 1\n");
+    }
+    byteCapacity capacity(maxCacheBytes, cacheEntries);
+    lruPages = NULL;
+    gdsfPages = NULL;
+    if (cachePolicy == "gdsf") {
+        gdsfPages = new gdsfPageCache(capacity);
+    } else {
+        lruPages = new lruPageCache(capacity);
+    }
+    requestsProcessed = 0;
+    supersededRequests = 0;
+    idempotentRetries = params.find<bool>("idempotentRetries", false);
+    mergedMisses = 0;
+    suppressedResponses = 0;
+
+    // fair queueing puts server fills first, then shares the rest between 
+    // users' first requests and retries by weight, taking turns between 
+    // users within each class
+    std::string queuePolicy = params.find<std::string>("queuePolicy", "fifo");
+    if (queuePolicy != "fifo" && queuePolicy != "fair") {
+        output.fatal(CALL_INFO, -1, "Unknown 'queuePolicy' %s, expected fifo or fair\n", queuePolicy.c_str());
+    }
+    int queueQuantum = params.find<int>("queueQuantum", 1);
+    if (queueQuantum < 1) {
+        output.fatal(CALL_INFO, -1, "Parameter 'queueQuantum' must be at least 1\n");
+    }
+    int firstWeight = params.find<int>("firstWeight", 3);
+    int retryWeight = params.find<int>("retryWeight", 1);
+    if (firstWeight < 1 || retryWeight < 1) {
+        output.fatal(CALL_INFO, -1, "Parameters 'firstWeight' and 'retryWeight' must be at least 1\n");
+    }
+    memoryRequests = new requestScheduler(queuePolicy == "fair", queueQuantum, firstWeight, retryWeight);
+
+    // an invalidated page is either deleted, so the next request for it goes 
+    // to the server, or kept and refreshed from the server in the background
+    invalidationPolicy = params.find<std::string>("invalidationPolicy", "delete");
+    if (invalidationPolicy != "delete" && invalidationPolicy != "refresh") {
+        output.fatal(CALL_INFO, -1, "Unknown 'invalidationPolicy' %s, expected delete or refresh\n", invalidationPolicy.c_str());
+    }
+    invalidationsReceived = 0;
+    pagesInvalidated = 0;
+    refetchMisses = 0;
+    refreshesSent = 0;
+    refreshHits = 0;
+    refreshesRefused = 0;
+
+    // herd detection metrics are computed over a sliding window, and log an 
+    // alarm whenever they cross a threshold (a threshold of 0 disables it)
+    SST::UnitAlgebra metricWindow = params.find<SST::UnitAlgebra>("metricWindow", "10s");
+    if ( !metricWindow.hasUnits("s") ) {
+        output.fatal(CALL_INFO, -1, "Parameter 'metricWindow' must be a time\n");
+    }
+    int metricBuckets = params.find<int>("metricBuckets", 10);
+    if (metricBuckets < 1) {
+        output.fatal(CALL_INFO, -1, "Parameter 'metricBuckets' must be at least 1\n");
+    }
+    std::vector<double> thresholds = {
+        params.find<double>("pageRateAlarm", 0.0),
+        params.find<double>("duplicateMissAlarm", 0.0),
+        params.find<double>("retryRatioAlarm", 0.0),
+        params.find<double>("burstinessAlarm", 0.0)
+    };
+    metrics = new herdDetector(&output, (uint64_t)(metricWindow.getDoubleValue() * 1e9),
+        metricBuckets, thresholds);
+
+    // the circuit breaker stops forwarding misses once the server is slow or 
+    // failing, serving stale pages or failing fast until probes get through
+    breaker = NULL;
+    if (params.find<bool>("circuitBreaker", false)) {
+        auto findTime = [&](const std::string &name, const std::string &defaultTime) {
+            SST::UnitAlgebra time = params.find<SST::UnitAlgebra>(name, defaultTime);
+            if ( !time.hasUnits("s") ) {
+                output.fatal(CALL_INFO, -1, "Parameter '%s' must be a time\n", name.c_str());
+            }
+            return (uint64_t)(time.getDoubleValue() * 1e9);
+        };
+        breakerSettings settings;
+        settings.slowCallLength = findTime("breakerSlowCall", "20s");
+        breakerSlowCall = settings.slowCallLength;
+        settings.windowLength = findTime("breakerWindow", "60s");
+        settings.minimumCalls = params.find<uint64_t>("breakerMinimumCalls", 5);
+        settings.failureRate = params.find<double>("breakerFailureRate", 0.5);
+        settings.openLength = findTime("breakerOpenLength", "30s");
+        settings.probeCalls = params.find<uint64_t>("breakerProbeCalls", 3);
+        breaker = new circuitBreaker(settings, [this](breakerState from, breakerState to) {
+            logBreakerTransition(from, to);
+        });
+        breakerOpened = registerStatistic<uint64_t>("breakerOpened");
+        breakerHalfOpened = registerStatistic<uint64_t>("breakerHalfOpened");
+        breakerClosed = registerStatistic<uint64_t>("breakerClosed");
+        staleResponses = registerStatistic<uint64_t>("staleResponses");
+        fastFailures = registerStatistic<uint64_t>("fastFailures");
+    }
 
     /*
      * The register clock functions take in a duration of time that was defined 
@@ -21,50 +131,90 @@ websiteCache::websiteCache( SST::ComponentId_t id, SST::Params& params ) : SST::
      */
 	registerClock(websiteBrowsingLength, new SST::Clock::Handler<websiteCache>(this, &websiteCache::clockTick));
 	
-	// Configure our ports
-	userOne = configureLink("userOne", "1ns", new SST::Event::Handler<websiteCache>(this, &websiteCache::handleEvent));
-	if ( !userOne ) {
-		output.fatal(CALL_INFO, -1, "Failed to configure port 'userOne'\n");
-	}
-    userTwo = configureLink("userTwo", "1ns", new SST::Event::Handler<websiteCache>(this, &websiteCache::handleEvent));
-	if ( !userTwo ) {
-		output.fatal(CALL_INFO, -1, "Failed to configure port 'userTwo'\n");
-	}
-    userThree = configureLink("userThree", "1ns", new SST::Event::Handler<websiteCache>(this, &websiteCache::handleEvent));
-	if ( !userThree ) {
-		output.fatal(CALL_INFO, -1, "Failed to configure port 'userThree'\n");
-	}
-    userFour = configureLink("userFour", "1ns", new SST::Event::Handler<websiteCache>(this, &websiteCache::handleEvent));
-	if ( !userFour ) {
-		output.fatal(CALL_INFO, -1, "Failed to configure port 'userFour'\n");
-	}
-    userFive = configureLink("userFive", "1ns", new SST::Event::Handler<websiteCache>(this, &websiteCache::handleEvent));
-	if ( !userFive ) {
-		output.fatal(CALL_INFO, -1, "Failed to configure port 'userFive'\n");
+	// load the optional sampler and tell it what to record
+	sampler = loadUserSubComponent<timeSeriesSampler>("sampler");
+	if ( sampler ) {
+		sampler->addProbe("queueDepth", [this]() { return (double)memoryRequests->size(); });
+		sampler->addProbe("cacheEntries", [this]() { return usePages([](auto &pages) { return (double)pages.size(); }); });
+		sampler->addProbe("cacheBytes", [this]() { return usePages([](auto &pages) { return (double)pages.usedCapacity(); }); });
+		if ( breaker ) {
+			sampler->addProbe("breakerState", [this]() { return (double)breaker->getState(getCurrentSimTimeNano()); });
+		}
 	}
-    websiteServer = configureLink("websiteServer", "1ns", new SST::Event::Handler<websiteCache>(this, &websiteCache::handleEvent));
+
+	// Configure our ports, the server is id 0 and users are numbered from 1
+	numUsers = params.find<int64_t>("numUsers", 5);
+	websiteServer = configureLink("websiteServer", "1ns", new SST::Event::Handler<websiteCache, int>(this, &websiteCache::handleEvent, 0));
 	if ( !websiteServer ) {
 		output.fatal(CALL_INFO, -1, "Failed to configure port 'websiteServer'\n");
 	}
+	userLinks.push_back(websiteServer);
+	userRoutes.push_back(0);
+	for (int64_t user = 1; user <= numUsers; user++) {
+		std::string port = "user" + std::to_string(user);
+		SST::Link *userLink = configureLink(port, "1ns", new SST::Event::Handler<websiteCache, int>(this, &websiteCache::handleEvent, user));
+		if ( !userLink ) {
+			output.fatal(CALL_INFO, -1, "Failed to configure port '%s'\n", port.c_str());
+		}
+		userLinks.push_back(userLink);
+		userRoutes.push_back(user);
+	}
 }
 
 websiteCache::~websiteCache() {
+    delete metrics;
+    delete memoryRequests;
+    delete breaker;
+    delete lruPages;
+    delete gdsfPages;
+}
+
+void websiteCache::setup() {
+    // SST only sets up components, so the sampler is set up from here
+    if ( sampler ) {
+        sampler->setup();
+    }
+}
 
+void websiteCache::finish() {
+    if ( sampler ) {
+        sampler->finish();
+    }
+    output.output(CALL_INFO, "processed %lu requests \n", requestsProcessed);
+    output.output(CALL_INFO, "dropped %lu superseded requests, merged %lu misses already at the server, suppressed %lu duplicate responses \n",
+        supersededRequests, mergedMisses, suppressedResponses);
+    output.output(CALL_INFO, "received %lu invalidations for %lu pages, %lu misses refetched invalidated pages, sent %lu refreshes, served %lu hits while refreshing, kept %lu pages the breaker would not refresh \n",
+        invalidationsReceived, pagesInvalidated, refetchMisses, refreshesSent, refreshHits, refreshesRefused);
+    metrics->printSummary();
 }
 
 // TODO functions:
 // randomize error for sites to have to access server
 bool websiteCache::clockTick( SST::Cycle_t currentCycle ) {
     // output.output(CALL_INFO, "Cache Sim-Time: %ld\n", getCurrentSimTimeNano());
-    // check if there's a request in the queue to process
-    if (memoryRequests.size() > 0) {
-        CacheRequestEvent *cacheev = memoryRequests.front();
-        memoryRequests.pop();
-    
+    // check if there's a request in the queue to process, requests that a 
+    // newer request from the same user replaced are dropped without using 
+    // up this cycle
+    if ( breaker ) {
+        checkServerTimeouts();
+    }
+    CacheRequestEvent *cacheev = NULL;
+    while (cacheev == NULL && memoryRequests->size() > 0) {
+        cacheev = memoryRequests->pop();
+        if (cacheev->cachereq.request == USER && idempotentRetries && !requestKeys.release(cacheev->cachereq.id, cacheev->cachereq.sequence)) {
+            output.verbose(CALL_INFO, 2, 0, "dropping superseded request from user %d \n", (int)cacheev->cachereq.id);
+            supersededRequests++;
+            delete cacheev;
+            cacheev = NULL;
+        }
+    }
+
     if ( cacheev != NULL ) {
+        requestsProcessed++;
         // unwrap CacheRequestEvent
         requester requester = cacheev->cachereq.request;
         int userID = cacheev->cachereq.id;
+        uint64_t sequence = cacheev->cachereq.sequence;
         std::string pageRequested = cacheev->cachereq.pageRequested;
         std::string urlRequested = cacheev->cachereq.urlRequested;
         bool successfulReturn = cacheev->cachereq.successfulReturn;
@@ -72,96 +222,276 @@ bool websiteCache::clockTick( SST::Cycle_t currentCycle ) {
         // cache recieves requests from both server and users,
         // so we need to differentiate the two
         if (requester == USER) {
-            output.output(CALL_INFO, "recieved a user request \n");
+            output.verbose(CALL_INFO, 2, 0, "recieved a user request \n");
             // check if we have url saved in cache
-            if (websitesInCache.count(pageRequested)) {
+            bool cached = usePages([&](auto &pages) { return pages.contains(pageRequested); });
+            if (idempotentRetries && cached && answeredSequence[userID] == sequence) {
+                // the user already has a reply to this request on the way
+                output.verbose(CALL_INFO, 2, 0, "already answered request %lu from user %d \n", sequence, userID);
+                suppressedResponses++;
+            } else if (cached) {
                 // access the url the user requested, and send it to them
                 // wrap the message in the UserRequestEvent
-                // update websiteAge to indicate least recently used item
-                websitesInCache[pageRequested].websiteAge = getCurrentSimTimeNano();
-                output.output(CALL_INFO, "returning page %s \n", websitesInCache[pageRequested].websiteUrl.c_str());
-                struct UserRequest userreq = { websitesInCache[pageRequested].websiteUrl, true };
-                returnUserLink(userID)->send(new UserRequestEvent(userreq));
+                // the lookup counts as a use for the replacement policy
+                cacheObject &site = *usePages([&](auto &pages) { return pages.find(pageRequested); });
+                if (refreshingPages.count(pageRequested)) {
+                    // the old version is served until the refresh arrives
+                    refreshHits++;
+                }
+                output.verbose(CALL_INFO, 2, 0, "returning page %s \n", site.websiteUrl.c_str());
+                struct UserRequest userreq = { site.websiteUrl, true, userID };
+                // the page reaches the user once all of its bytes are sent
+                returnUserLink(userID)->send(transferDelay(userID, site.websiteSize), new UserRequestEvent(userreq));
+                answeredSequence[userID] = sequence;
+                if ( breaker ) {
+                    forgetSupersededMisses(userID, sequence);
+                }
+            } else if (idempotentRetries && forwardedSequence.count(userID) && forwardedSequence[userID] == sequence) {
+                // a retry of a request the server is already working on
+                output.verbose(CALL_INFO, 2, 0, "request %lu from user %d is already at the server \n", sequence, userID);
+                mergedMisses++;
+            } else if (breaker && !breaker->allowRequest(getCurrentSimTimeNano())) {
+                // the server is struggling, answer without it
+                serveWithoutServer(userID, sequence, pageRequested);
             } else {
                 // send request to server for url
-                struct ServerRequest serverreq = { pageRequested, userID };
+                if (invalidatedPages.count(pageRequested)) {
+                    refetchMisses++;
+                }
+                metrics->recordMiss(getCurrentSimTimeNano(), pageRequested);
+                struct ServerRequest serverreq = { pageRequested, userID, sequence };
                 returnUserLink(0)->send(new ServerRequestEvent(serverreq));
+                forwardedSequence[userID] = sequence;
+                if ( breaker ) {
+                    // remember when the miss left, to time the server's response
+                    forgetSupersededMisses(userID, sequence);
+                    std::pair<int64_t, uint64_t> key(userID, sequence);
+                    outstandingMisses.emplace(key, getCurrentSimTimeNano());
+                    missOrder.push_back(std::make_pair(getCurrentSimTimeNano(), key));
+                }
             }
 
         // server is sending back a requested url, implement cache replacement
         } else if ( requester == SERVER ) {
-            output.output(CALL_INFO, "recieved a server request \n");
+            output.verbose(CALL_INFO, 2, 0, "recieved a server request \n");
+            // the user's next retry may go to the server again
+            if (forwardedSequence.count(userID) && forwardedSequence[userID] == sequence) {
+                forwardedSequence.erase(userID);
+            }
+            if ( breaker ) {
+                auto sent = outstandingMisses.find(std::make_pair((int64_t)userID, sequence));
+                if (sent != outstandingMisses.end()) {
+                    breaker->recordResponse(getCurrentSimTimeNano(), getCurrentSimTimeNano() - sent->second, successfulReturn);
+                    outstandingMisses.erase(sent);
+                }
+            }
             if (successfulReturn) {
-                // if there's room in the cache, just insert it in the map
-                if (websitesInCache.size() < maxCacheSize) {
-                    struct cacheObject newsite = {urlRequested, getCurrentSimTimeNano()};
-                    websitesInCache[pageRequested] = newsite;
-                } else {
-                    // map traversal from https://www.geeksforgeeks.org/traversing-a-map-or-unordered_map-in-cpp-stl/
-                    // looping through to find the object that was inserted earliest
-                    
-                    // initalize time comparison to be the latest time in the simulation
-                    long int oldestTime = 990000000000;
-                    std::string lruSite = "";
-                    std::map<std::string, cacheObject>::iterator it = websitesInCache.begin();
-
-                    // iterate through map, compare time stamps
-                    while (it != websitesInCache.end()) {
-                        std::string word = it->first;
-                        cacheObject cacheObject = it->second;
-                        int cacheObjectTime = cacheObject.websiteAge;
-                        if (cacheObjectTime < oldestTime) {
-                            oldestTime = cacheObjectTime;
-                            lruSite = word;
-                        }
-                        // iterator incremented to point next item
-                        it++;
-                    }
-                    // found oldest item to be replaced, delete from cache and replace
-                    output.output(CALL_INFO, "oldest item is %s \n",lruSite.c_str());
-                    websitesInCache.erase(lruSite);
-                    output.output(CALL_INFO, "replacing item with %s \n",urlRequested.c_str());
-                    struct cacheObject newsite = {urlRequested, getCurrentSimTimeNano()};
-                    websitesInCache[pageRequested] = newsite;
+                metrics->recordFill(pageRequested);
+                insertWebsite(pageRequested, urlRequested, cacheev->cachereq.pageSize);
+                invalidatedPages.erase(pageRequested);
+                refreshingPages.erase(pageRequested);
+                if (refreshAgainPages.erase(pageRequested)) {
+                    // the page may have been updated after this copy was sent
+                    refreshWebsite(pageRequested);
                 }
             }
+
+        // server has updated a page, an empty page name means every page
+        } else if ( requester == INVALIDATION ) {
+            output.verbose(CALL_INFO, 2, 0, "recieved an invalidation \n");
+            invalidationsReceived++;
+            std::vector<std::string> pages;
+            if (pageRequested.empty()) {
+                usePages([&](auto &cached) {
+                    cached.forEach([&](const std::string &page, const cacheObject &site) { pages.push_back(page); });
+                    return pages.size();
+                });
+            } else if (usePages([&](auto &cached) { return cached.contains(pageRequested); })) {
+                pages.push_back(pageRequested);
+            }
+            for (const std::string &page : pages) {
+                invalidateWebsite(page);
+            }
         }
-    }
+        delete cacheev;
     }
     return false;
 }
 
-void websiteCache::handleEvent(SST::Event *ev) {
+void websiteCache::insertWebsite(std::string pageRequested, std::string urlRequested, uint64_t pageSize) {
+    // a page bigger than the whole cache can never be stored
+    if (pageSize > maxCacheBytes) {
+        output.verbose(CALL_INFO, 2, 0, "page %s (%lu bytes) is larger than the cache \n", pageRequested.c_str(), pageSize);
+        return;
+    }
+
+    // an updated copy of a page we already hold replaces the old one, and 
+    // pages are evicted until the new one fits
+    output.verbose(CALL_INFO, 2, 0, "inserting %s (%lu bytes) \n", urlRequested.c_str(), pageSize);
+    struct cacheObject newsite = { urlRequested, pageSize };
+    usePages([&](auto &pages) {
+        return pages.insert(pageRequested, newsite, pageSize, [this](const std::string &page, const cacheObject &site) {
+            evictWebsite(page, site);
+        });
+    });
+    staleWebsites.erase(pageRequested);
+}
+
+void websiteCache::evictWebsite(const std::string &pageRequested, const cacheObject &site) {
+    // the cache core picks the item to be replaced, which is the one accessed 
+    // earliest for LRU, or the one with the lowest priority for GDSF. Keep a 
+    // stale copy to serve while the circuit breaker is open
+    output.verbose(CALL_INFO, 2, 0, "evicting item %s \n", pageRequested.c_str());
+    if ( breaker ) {
+        staleWebsites[pageRequested] = site;
+    }
+}
+
+void websiteCache::invalidateWebsite(std::string pageRequested) {
+    pagesInvalidated++;
+    if (invalidationPolicy == "refresh") {
+        // keep serving the old copy, and fetch the new one ahead of the users
+        if (refreshingPages.count(pageRequested)) {
+            // the pending refresh may bring back the version before this 
+            // update, so ask again once it lands
+            refreshAgainPages.insert(pageRequested);
+        } else {
+            refreshWebsite(pageRequested);
+        }
+        return;
+    }
+
+    // drop the page, keeping a stale copy to serve while the circuit breaker 
+    // is open, every user who wants it now has to wait on the server
+    output.verbose(CALL_INFO, 2, 0, "deleting invalidated page %s \n", pageRequested.c_str());
+    usePages([&](auto &pages) {
+        if ( breaker ) {
+            staleWebsites[pageRequested] = *pages.peek(pageRequested);
+        }
+        return pages.erase(pageRequested);
+    });
+    invalidatedPages.insert(pageRequested);
+}
+
+void websiteCache::refreshWebsite(std::string pageRequested) {
+    // refreshes go through the breaker like misses, when it refuses the 
+    // old copy stays until a later invalidation is let through
+    if (breaker && !breaker->allowRequest(getCurrentSimTimeNano())) {
+        output.verbose(CALL_INFO, 2, 0, "circuit open, keeping invalidated page %s \n", pageRequested.c_str());
+        refreshesRefused++;
+        return;
+    }
+    output.verbose(CALL_INFO, 2, 0, "refreshing invalidated page %s \n", pageRequested.c_str());
+    refreshingPages.insert(pageRequested);
+    // refreshes are sent as user 0, numbered so the breaker can time each
+    struct ServerRequest serverreq = { pageRequested, 0, ++refreshesSent };
+    returnUserLink(0)->send(new ServerRequestEvent(serverreq));
+    if ( breaker ) {
+        std::pair<int64_t, uint64_t> key(0, refreshesSent);
+        outstandingMisses.emplace(key, getCurrentSimTimeNano());
+        missOrder.push_back(std::make_pair(getCurrentSimTimeNano(), key));
+    }
+}
+
+void websiteCache::serveWithoutServer(int userID, uint64_t sequence, std::string pageRequested) {
+    if (staleWebsites.count(pageRequested)) {
+        // an old copy is better than nothing while the server recovers
+        cacheObject &site = staleWebsites[pageRequested];
+        output.verbose(CALL_INFO, 2, 0, "circuit open, returning stale page %s \n", site.websiteUrl.c_str());
+        struct UserRequest userreq = { site.websiteUrl, true, userID };
+        returnUserLink(userID)->send(transferDelay(userID, site.websiteSize), new UserRequestEvent(userreq));
+        answeredSequence[userID] = sequence;
+        forgetSupersededMisses(userID, sequence);
+        staleResponses->addData(1);
+    } else {
+        // fail fast, the user will retry after their refresh time
+        output.verbose(CALL_INFO, 2, 0, "circuit open, failing request for %s \n", pageRequested.c_str());
+        struct UserRequest userreq = { "", false, userID };
+        returnUserLink(userID)->send(new UserRequestEvent(userreq));
+        fastFailures->addData(1);
+    }
+}
+
+void websiteCache::checkServerTimeouts() {
+    // misses are sent in time order, so only the oldest ones can have expired
+    uint64_t now = getCurrentSimTimeNano();
+    while (!missOrder.empty() && missOrder.front().first + breakerSlowCall <= now) {
+        auto sent = outstandingMisses.find(missOrder.front().second);
+        if (sent != outstandingMisses.end() && sent->second == missOrder.front().first) {
+            breaker->recordTimeout(now);
+            outstandingMisses.erase(sent);
+        }
+        missOrder.pop_front();
+    }
+}
+
+void websiteCache::forgetSupersededMisses(int userID, uint64_t sequence) {
+    // the user has moved on, so the server never answering these is not a 
+    // sign of trouble, their entries in missOrder are skipped once erased
+    outstandingMisses.erase(outstandingMisses.lower_bound(std::make_pair((int64_t)userID, (uint64_t)0)),
+                            outstandingMisses.lower_bound(std::make_pair((int64_t)userID, sequence)));
+}
+
+void websiteCache::logBreakerTransition(breakerState from, breakerState to) {
+    const char *names[] = { "closed", "open", "half-open" };
+    output.output(CALL_INFO, "circuit breaker %s -> %s at %lu ns \n", names[from], names[to], getCurrentSimTimeNano());
+    if (to == BREAKER_OPEN) {
+        breakerOpened->addData(1);
+    } else if (to == BREAKER_HALF_OPEN) {
+        breakerHalfOpened->addData(1);
+    } else {
+        breakerClosed->addData(1);
+    }
+}
+
+SST::SimTime_t websiteCache::transferDelay(int userid, uint64_t bytes) {
+    // a payload starts once the ones already on the link have been sent, 
+    // link time base is 1ns, so convert the transfer time to nanoseconds
+    SST::SimTime_t now = getCurrentSimTimeNano();
+    SST::SimTime_t &busyUntil = userBusyUntil[userid];
+    busyUntil = std::max(now, busyUntil) + (SST::SimTime_t)(bytes * 1e9 / linkBandwidth);
+    return busyUntil - now;
+}
+
+void websiteCache::handleEvent(SST::Event *ev, int port) {
     // push incoming requests to a queue
-    output.output(CALL_INFO, "Sim-Time in cache: %ld\n", getCurrentSimTimeNano());
+    output.verbose(CALL_INFO, 2, 0, "Sim-Time in cache: %ld\n", getCurrentSimTimeNano());
     CacheRequestEvent *cacheev = dynamic_cast<CacheRequestEvent*>(ev);
-    memoryRequests.push(cacheev);
-    output.output(CALL_INFO, "number of cache requests: %ld \n", memoryRequests.size());
+    if ( cacheev == NULL ) {
+        output.output(CALL_INFO, "ignoring an unexpected event \n");
+        delete ev;
+        return;
+    }
+    if ( cacheev->cachereq.request == USER ) {
+        // a userPopulation sends many user ids over one port, so remember 
+        // which port each id arrived on to send the reply back the same way
+        int64_t userID = cacheev->cachereq.id;
+        // id 0 is the route to the server, so user ids start at 1
+        if (userID < 1) {
+            output.fatal(CALL_INFO, -1, "Recieved a request from user %ld, user ids must be at least 1\n", userID);
+        }
+        if (userID >= (int64_t)userRoutes.size()) {
+            userRoutes.resize(userID + 1, -1);
+        }
+        userRoutes[userID] = port;
+        metrics->recordRequest(getCurrentSimTimeNano(), cacheev->cachereq.pageRequested, cacheev->cachereq.retryCount > 0);
+
+        // a retry of a request that is still queued is merged into it
+        if (idempotentRetries && !requestKeys.admit(userID, cacheev->cachereq.sequence)) {
+            output.verbose(CALL_INFO, 2, 0, "merging retry from user %ld into its queued request \n", userID);
+            supersededRequests++;
+            delete cacheev;
+            return;
+        }
+    }
+    memoryRequests->push(cacheev);
+    output.verbose(CALL_INFO, 2, 0, "number of cache requests: %ld \n", memoryRequests->size());
 }
 
 
 SST::Link * websiteCache::returnUserLink(int userid) {
-    switch (userid) {
-    case 0:
-        return websiteServer;
-        break;
-    case 1:
-        return userOne;
-        break;
-    case 2:
-        return userTwo;
-        break;
-    case 3:
-        return userThree;
-        break;
-    case 4:
-        return userFour;
-        break;
-    case 5:
-        return userFive;
-        break;
-    default:
+    if (userid < 0 || userid >= (int)userRoutes.size() || userRoutes[userid] < 0) {
         return 0; // unexpected id, return null
-        break;
     }
+    return userLinks[userRoutes[userid]];
 }
@@ -6,7 +6,18 @@
 #include <sst/core/rng/marsaglia.h>
 #include <sst/core/event.h>
 #include "requests.h"
+#include "timeSeriesSampler.h"
+#include "herdMetrics.h"
+#include "requestScheduler.h"
+#include "requestKeys.h"
+#include "circuitBreaker.h"
+#include "cacheCore.h"
+#include <map>
+#include <deque>
 #include <queue>
+#include <set>
+#include <unordered_map>
+#include <vector>
 
 /**
  * @file websiteCache.h
@@ -15,6 +26,10 @@
  * 
  */
 
+/* the cache's pages by name, with either replacement policy, sized in bytes */
+typedef cacheCore<std::string, cacheObject, lruPolicy, byteCapacity> lruPageCache;
+typedef cacheCore<std::string, cacheObject, gdsfPolicy, byteCapacity> gdsfPageCache;
+
 class websiteCache : public SST::Component {
 
 public:
@@ -33,6 +48,20 @@ public:
 	 */
 	~websiteCache();
 
+	/**
+	 * @brief Sets up the sampler, if one was loaded
+	 * 
+	 */
+	void setup();
+
+	/**
+	 * @brief Logs how many requests were processed or removed as duplicates, 
+	 * and the peak value of each herd detection metric at the end of the 
+	 * simulation
+	 * 
+	 */
+	void finish();
+
 	/**
 	 * @brief This clock function checks the queue, and processes 
 	 * a defined amount of requests every cycle.
@@ -56,8 +85,100 @@ public:
 	 * users, and queues them up to be processed in the clock function
 	 * 
 	 * @param ev An event object that contains the details of the request
+	 * @param port Index of the port the event arrived on, 0 for the server
+	 */
+    void handleEvent(SST::Event *ev, int port);
+
+	/**
+	 * @brief Stores a page sent back by the server, evicting other pages 
+	 * with the configured policy until there are enough free bytes for it
+	 * 
+	 * @param pageRequested name of the website
+	 * @param urlRequested url of the website
+	 * @param pageSize size of the page in bytes
+	 */
+	void insertWebsite(std::string pageRequested, std::string urlRequested, uint64_t pageSize);
+
+	/**
+	 * @brief Called for each page the cache core evicts, chosen by least 
+	 * recent access for LRU or by lowest priority for GDSF
+	 * 
+	 * @param pageRequested name of the website
+	 * @param site the evicted page
+	 */
+	void evictWebsite(const std::string &pageRequested, const cacheObject &site);
+
+	/**
+	 * @brief Handles the server updating a cached page, either deleting it 
+	 * or keeping it and asking the server for the new version
+	 * 
+	 * @param pageRequested name of the website
+	 */
+	void invalidateWebsite(std::string pageRequested);
+
+	/**
+	 * @brief Asks the server for the new version of an invalidated page, 
+	 * unless the circuit breaker refuses
+	 * 
+	 * @param pageRequested name of the website
+	 */
+	void refreshWebsite(std::string pageRequested);
+
+	/**
+	 * @brief Answers a miss while the circuit breaker is open, with a stale 
+	 * copy of the page if one was kept, or else a fast failure
+	 * 
+	 * @param userID id of the user who requested the page
+	 * @param sequence the user's number for the request
+	 * @param pageRequested name of the website
+	 */
+	void serveWithoutServer(int userID, uint64_t sequence, std::string pageRequested);
+
+	/**
+	 * @brief Reports misses the server has not answered within the slow 
+	 * call length to the circuit breaker as failures
+	 * 
+	 */
+	void checkServerTimeouts();
+
+	/**
+	 * @brief Stops timing a user's misses older than their current request, 
+	 * which the server drops as superseded instead of answering
+	 * 
+	 * @param userID id of the user
+	 * @param sequence the user's number for their current request
+	 */
+	void forgetSupersededMisses(int userID, uint64_t sequence);
+
+	/**
+	 * @brief Logs a circuit breaker state change and counts it in the 
+	 * statistics
+	 * 
+	 */
+	void logBreakerTransition(breakerState from, breakerState to);
+
+	/**
+	 * @brief Calls use with whichever cache core the replacement policy 
+	 * selected, so the policy is resolved at compile time inside use
+	 * 
+	 */
+	template <typename Use>
+	auto usePages(Use use) {
+		return lruPages ? use(*lruPages) : use(*gdsfPages);
+	}
+
+	/**
+	 * @brief Computes how long it takes to push a payload across a user's 
+	 * link, given the configured link bandwidth. Payloads queue behind the 
+	 * ones still being sent to the same user. Busy time is kept per user 
+	 * rather than per port, so the users of a userPopulation each get their 
+	 * own bandwidth, the same as separate websiteUsers.
+	 * 
+	 * @param userid id of the user the payload is sent to
+	 * @param bytes Size of the payload being sent
+	 * @return SST::SimTime_t The delay until the payload arrives in nanoseconds
 	 */
-    void handleEvent(SST::Event *ev);
+	SST::SimTime_t transferDelay(int userid, uint64_t bytes);
 
 	/**
 	 * \cond
@@ -75,17 +196,53 @@ public:
 	// Parameter name, description, default value
 	SST_ELI_DOCUMENT_PARAMS(
 		{ "randomseed", "Random Seed for errors within simulation", "151515" },
+		{ "verbose", "Output verbosity, 2 prints every request, 1 only the end of simulation summary", "2" },
+		{ "numUsers", "Number of user ports, each connects a websiteUser or a userPopulation", "5" },
+		{ "websiteBrowsingLength", "How long the cache takes to process a request", "10ms" },
+		{ "maxCacheBytes", "Capacity of the cache in bytes", "131072" },
+		{ "cachePolicy", "Replacement policy, either lru or gdsf (size aware)", "lru" },
+		{ "cacheEntries", "Most pages the cache can hold, storage for them is allocated up front", "1024" },
+		{ "linkBandwidth", "Bandwidth of the links to the users, used to model page transfer time", "1GB/s" },
+		{ "queuePolicy", "Order requests are processed in, fifo or fair (fills first, first requests and retries shared by weight, round-robin between users)", "fifo" },
+		{ "queueQuantum", "Requests each user may have processed per round-robin turn with fair queueing", "1" },
+		{ "firstWeight", "First requests processed per turn of the first request class with fair queueing", "3" },
+		{ "retryWeight", "Retries processed per turn of the retry class with fair queueing, so retries always get a share", "1" },
+		{ "idempotentRetries", "Drop queued requests that a user's retry or newer request replaced, and send each reply once", "false" },
+		{ "circuitBreaker", "Stop forwarding misses to a slow or failing server", "false" },
+		{ "breakerSlowCall", "Server response time past which a miss counts as failed", "20s" },
+		{ "breakerWindow", "Sliding window the server failure rate is measured over", "60s" },
+		{ "breakerMinimumCalls", "Server responses needed in the window before the breaker can open", "5" },
+		{ "breakerFailureRate", "Fraction of failed server responses that opens the breaker", "0.5" },
+		{ "breakerOpenLength", "How long the breaker stays open before sending probes", "30s" },
+		{ "breakerProbeCalls", "Probes that must succeed in half-open to close the breaker", "3" },
+		{ "invalidationPolicy", "What an invalidation from the server does, delete the page or refresh it while serving the old copy", "delete" },
+		{ "metricWindow", "Length of the sliding window for herd detection metrics", "10s" },
+		{ "metricBuckets", "Number of buckets the metric window is split into", "10" },
+		{ "pageRateAlarm", "Requests per second for a single page that raise an alarm, 0 disables", "0" },
+		{ "duplicateMissAlarm", "Misses in the window for pages already in flight that raise an alarm, 0 disables", "0" },
+		{ "retryRatioAlarm", "Ratio of retries to first requests in the window that raises an alarm, 0 disables", "0" },
+		{ "burstinessAlarm", "Coefficient of variation of request inter-arrival times that raises an alarm, 0 disables", "0" },
 	)
 
 	// Port name, description, event type
 	SST_ELI_DOCUMENT_PORTS(
-		{ "userOne", "Communication to user one", {"sst.Interfaces.StringEvent"}},
-        { "userTwo", "Communication to user two", {"sst.Interfaces.StringEvent"}},
-        { "userThree", "Communication to user three", {"sst.Interfaces.StringEvent"}},
-        { "userFour", "Communication to user four", {"sst.Interfaces.StringEvent"}},
-        { "userFive", "Communication to user five", {"sst.Interfaces.StringEvent"}},
+		{ "user%(numUsers)d", "Communication to a websiteUser or a userPopulation, numbered from 1", {"sst.Interfaces.StringEvent"}},
 		{ "websiteServer", "Communication to website server", {"sst.Interfaces.StringEvent"}},
 	)
+
+	// Statistic name, description, units, enable level
+	SST_ELI_DOCUMENT_STATISTICS(
+		{ "breakerOpened", "Times the circuit breaker opened", "transitions", 1 },
+		{ "breakerHalfOpened", "Times the circuit breaker started probing the server", "transitions", 1 },
+		{ "breakerClosed", "Times the circuit breaker closed after the server recovered", "transitions", 1 },
+		{ "staleResponses", "Stale pages served while the breaker was open", "responses", 1 },
+		{ "fastFailures", "Requests failed fast while the breaker was open", "responses", 1 },
+	)
+
+	// Subcomponent slot name, description, interface
+	SST_ELI_DOCUMENT_SUBCOMPONENT_SLOTS(
+		{ "sampler", "Optional sampler recording queue depth and cache occupancy over time", "timeSeriesSampler" },
+	)
 	/**
 	 * \endcond
 	 */
@@ -98,16 +255,54 @@ private:
 	std::string websiteBrowsingLength; // defines frequency of clock
 
 	/* A collection of links to each of the users and the server */
-	SST::Link *userOne;
-    SST::Link *userTwo;
-    SST::Link *userThree;
-    SST::Link *userFour;
-    SST::Link *userFive;
 	SST::Link *websiteServer;
+	std::vector<SST::Link*> userLinks;	/* indexed by port, 0 is the server */
+	std::vector<int> userRoutes;		/* port each user id is reached on, -1 if unknown */
+	std::unordered_map<int64_t, SST::SimTime_t> userBusyUntil;	/* time in ns each user's link finishes its queued payloads */
+	int64_t numUsers;
+	uint64_t requestsProcessed;							/* requests taken off the queue */
+
+	/* (user, sequence) idempotency keys, so retries replace work instead of adding to it */
+	bool idempotentRetries;								/* whether duplicate requests are removed */
+	supersededFilter requestKeys;						/* drops queued requests a user has replaced */
+	std::unordered_map<int64_t, uint64_t> forwardedSequence;	/* request of each user waiting on the server */
+	std::unordered_map<int64_t, uint64_t> answeredSequence;	/* last request each user was sent a page for */
+	uint64_t supersededRequests;						/* requests dropped or merged before processing */
+	uint64_t mergedMisses;								/* retries not sent to the server again */
+	uint64_t suppressedResponses;						/* duplicate replies not sent */
+
+	/* circuit breaker between the cache and the server, NULL if disabled */
+	circuitBreaker *breaker;
+	uint64_t breakerSlowCall;							/* ns after which an unanswered miss has failed */
+	std::map<std::pair<int64_t, uint64_t>, uint64_t> outstandingMisses;	/* send time of misses at the server */
+	std::deque<std::pair<uint64_t, std::pair<int64_t, uint64_t>>> missOrder;	/* misses in the order they were sent */
+	std::map<std::string, cacheObject> staleWebsites;	/* evicted pages, served while the breaker is open */
+	SST::Statistics::Statistic<uint64_t> *breakerOpened;
+	SST::Statistics::Statistic<uint64_t> *breakerHalfOpened;
+	SST::Statistics::Statistic<uint64_t> *breakerClosed;
+	SST::Statistics::Statistic<uint64_t> *staleResponses;
+	SST::Statistics::Statistic<uint64_t> *fastFailures;
+
+	/* invalidations pushed by the server when it updates pages */
+	std::string invalidationPolicy;						/* delete or refresh */
+	std::set<std::string> invalidatedPages;				/* deleted pages not yet fetched again */
+	std::set<std::string> refreshingPages;				/* pages with a refresh at the server */
+	std::set<std::string> refreshAgainPages;			/* pages updated again while their refresh was pending */
+	uint64_t invalidationsReceived;
+	uint64_t pagesInvalidated;							/* cached pages the invalidations hit */
+	uint64_t refetchMisses;								/* misses on deleted pages before they were refilled */
+	uint64_t refreshesSent;
+	uint64_t refreshHits;								/* old copies served while a refresh was pending */
+	uint64_t refreshesRefused;							/* refreshes the circuit breaker did not allow */
 
-    std::map<std::string, cacheObject> websitesInCache;	/* internal map to model cache */
-	std::queue<CacheRequestEvent*> memoryRequests; 		/* holds requests to cache */
-	int maxCacheSize;									/* size limit to cache */
+	lruPageCache *lruPages;								/* pages when the policy is lru, else NULL */
+	gdsfPageCache *gdsfPages;							/* pages when the policy is gdsf, else NULL */
+	requestScheduler *memoryRequests; 					/* holds requests to cache */
+	uint64_t maxCacheBytes;								/* size limit to cache in bytes */
+	std::string cachePolicy;							/* lru or gdsf replacement */
+	double linkBandwidth;								/* bytes per second to the users */
+	herdDetector *metrics;								/* windowed herd detection metrics */
+	timeSeriesSampler *sampler;							/* optional sampler, NULL if not loaded */
 };
 
 #endif
\ No newline at end of file
@@ -3,15 +3,26 @@
 #include <sst/core/stopAction.h>
 #include <sst/core/simulation.h>
 #include "websiteServer.h"
+#include <algorithm>
 
 websiteServer::websiteServer( SST::ComponentId_t id, SST::Params& params ) : SST::Component(id) {
 
-    // initalizes the name of the server for our output
-    output.init("websiteServer-" + getName() + "-> ", 1, 0, SST::Output::STDOUT);
+    // initalizes the name of the server for our output, per request messages 
+    // are only printed with verbose set to 2 or higher
+    output.init("websiteServer-" + getName() + "-> ", params.find<uint32_t>("verbose", 2), 0, SST::Output::STDOUT);
 
     // This grabs the parameters that were defined in the python test file in 
     // order to initalize our component
 	websiteBrowsingLength = params.find<std::string>("websiteBrowsingLength", "5s");
+    SST::UnitAlgebra bandwidth = params.find<SST::UnitAlgebra>("linkBandwidth", "1GB/s");
+    if ( !bandwidth.hasUnits("B/s") || bandwidth.getDoubleValue() <= 0 ) {
+        output.fatal(CALL_INFO, -1, "Parameter 'linkBandwidth' must be a positive rate in B/s\n");
+    }
+    linkBandwidth = bandwidth.getDoubleValue();
+    linkBusyUntil = 0;
+    requestsProcessed = 0;
+    supersededRequests = 0;
+    idempotentRetries = params.find<bool>("idempotentRetries", false);
 
     /*
      * The register clock functions take in a duration of time that was defined 
@@ -20,14 +31,76 @@ websiteServer::websiteServer( SST::ComponentId_t id, SST::Params& params ) : SST
      */
 	registerClock(websiteBrowsingLength, new SST::Clock::Handler<websiteServer>(this, &websiteServer::clockTick));
 	
-	// initalize the server to have all the available websites, and their urls
-    websites["login"] = "login.com";
-    websites["profile1"] = "profile1.com";
-    websites["profile2"] = "profile2.com";
-    websites["profile3"] = "profile3.com";
-    websites["profile4"] = "profile4.com";
-    websites["settings"] = "settings.com";
-    websites["about"] = "about.com";
+	// initalize the server to have all the available websites, their urls, 
+    // and how many bytes each page takes to send
+    websites["login"] = { "login.com", 4096 };
+    websites["profile1"] = { "profile1.com", 65536 };
+    websites["profile2"] = { "profile2.com", 65536 };
+    websites["profile3"] = { "profile3.com", 65536 };
+    websites["profile4"] = { "profile4.com", 65536 };
+    websites["settings"] = { "settings.com", 8192 };
+    websites["about"] = { "about.com", 16384 };
+
+    // page sizes can be overridden from the python file as "page:bytes"
+    std::vector<std::string> pageSizes;
+    params.find_array<std::string>("pageSizes", pageSizes);
+    for (const std::string &entry : pageSizes) {
+        size_t split = entry.find(':');
+        if (split == std::string::npos || websites.count(entry.substr(0, split)) == 0) {
+            output.fatal(CALL_INFO, -1, "Invalid 'pageSizes' entry '%s'\n", entry.c_str());
+        }
+        // the size must be a whole number of bytes that fits in 64 bits
+        std::string bytes = entry.substr(split + 1);
+        if (bytes.empty() || bytes.size() > 19 || bytes.find_first_not_of("0123456789") != std::string::npos) {
+            output.fatal(CALL_INFO, -1, "Invalid size in 'pageSizes' entry '%s'\n", entry.c_str());
+        }
+        websites[entry.substr(0, split)].websiteSize = std::stoull(entry.substr(split + 1));
+    }
+
+    // pages can be updated on a schedule, each update changes the page's url 
+    // and tells the cache to invalidate it
+    std::string updateInterval = params.find<std::string>("updateInterval", "0s");
+    if ( !SST::UnitAlgebra(updateInterval).hasUnits("s") ) {
+        output.fatal(CALL_INFO, -1, "Parameter 'updateInterval' must be a time\n");
+    }
+    params.find_array<std::string>("updatePages", updatePages);
+    if (updatePages.empty()) {
+        for (auto &page : websites) {
+            updatePages.push_back(page.first);
+        }
+    }
+    for (const std::string &page : updatePages) {
+        if (websites.count(page) == 0) {
+            output.fatal(CALL_INFO, -1, "Unknown page '%s' in 'updatePages'\n", page.c_str());
+        }
+    }
+    nextUpdate = 0;
+    pagesUpdated = 0;
+
+    // broadcast invalidates every cached page on each update, dependency only 
+    // invalidates the updated page and the pages that depend on it
+    invalidationMode = params.find<std::string>("invalidationMode", "dependency");
+    if (invalidationMode != "broadcast" && invalidationMode != "dependency") {
+        output.fatal(CALL_INFO, -1, "Unknown 'invalidationMode' %s, expected broadcast or dependency\n", invalidationMode.c_str());
+    }
+    std::vector<std::string> pageDependencies;
+    params.find_array<std::string>("pageDependencies", pageDependencies);
+    for (const std::string &entry : pageDependencies) {
+        size_t split = entry.find(':');
+        if (split == std::string::npos || websites.count(entry.substr(0, split)) == 0 || websites.count(entry.substr(split + 1)) == 0) {
+            output.fatal(CALL_INFO, -1, "Invalid 'pageDependencies' entry '%s'\n", entry.c_str());
+        }
+        dependentPages[entry.substr(0, split)].push_back(entry.substr(split + 1));
+    }
+    if (SST::UnitAlgebra(updateInterval).getDoubleValue() > 0) {
+        registerClock(updateInterval, new SST::Clock::Handler<websiteServer>(this, &websiteServer::updateTick));
+    }
+
+	// load the optional sampler and tell it what to record
+	sampler = loadUserSubComponent<timeSeriesSampler>("sampler");
+	if ( sampler ) {
+		sampler->addProbe("queueDepth", [this]() { return (double)memoryRequests.size(); });
+	}
 
 	// Configure our port to the cache
 	websiteCache = configureLink("websiteCache", "1ns", new SST::Event::Handler<websiteServer>(this, &websiteServer::handleEvent));
@@ -40,29 +113,125 @@ websiteServer::~websiteServer() {
 
 }
 
+void websiteServer::setup() {
+    // SST only sets up components, so the sampler is set up from here
+    if ( sampler ) {
+        sampler->setup();
+    }
+}
+
+void websiteServer::finish() {
+    if ( sampler ) {
+        sampler->finish();
+    }
+    output.output(CALL_INFO, "processed %lu requests \n", requestsProcessed);
+    output.output(CALL_INFO, "dropped %lu superseded requests \n", supersededRequests);
+    output.output(CALL_INFO, "updated %lu pages \n", pagesUpdated);
+}
+
 bool websiteServer::clockTick( SST::Cycle_t currentCycle ) {
     // output.output(CALL_INFO, "Server Sim-Time: %ld\n", getCurrentSimTimeNano());
-    // check that there's an event in the queue to process
-    if (memoryRequests.size() > 0) {
-        ServerRequestEvent *serverev = memoryRequests.front();
+    // check that there's an event in the queue to process, requests that a 
+    // newer request from the same user replaced are dropped without using 
+    // up this cycle
+    ServerRequestEvent *serverev = NULL;
+    while (serverev == NULL && memoryRequests.size() > 0) {
+        serverev = memoryRequests.front();
         memoryRequests.pop();
-        if ( serverev != NULL ) {
+        if (idempotentRetries && serverev->serverreq.id != 0 && !requestKeys.release(serverev->serverreq.id, serverev->serverreq.sequence)) {
+            output.verbose(CALL_INFO, 2, 0, "dropping superseded request from user %d \n", (int)serverev->serverreq.id);
+            supersededRequests++;
+            delete serverev;
+            serverev = NULL;
+        }
+    }
+
+    if ( serverev != NULL ) {
+        requestsProcessed++;
         std::string pageRequested = serverev->serverreq.pageRequested;
         int userID = serverev->serverreq.id;
+        uint64_t sequence = serverev->serverreq.sequence;
 
         // temporarily just always return true
         // future step: randomize bad requests from server
-        output.output(CALL_INFO, "is now sending over to cache: %s \n", websites[pageRequested].c_str());
-        struct CacheRequest cachereq = { SERVER, userID, pageRequested, websites[pageRequested], 1 };
-        websiteCache->send(new CacheRequestEvent(cachereq));
+        websitePage page = websites[pageRequested];
+        std::string url = pageUrl(page);
+        output.verbose(CALL_INFO, 2, 0, "is now sending over to cache: %s (%lu bytes)\n", url.c_str(), page.websiteSize);
+        struct CacheRequest cachereq = { SERVER, userID, pageRequested, url, 1, page.websiteSize, 0, sequence };
+        // the page arrives once all of its bytes have crossed the link
+        websiteCache->send(transferDelay(page.websiteSize), new CacheRequestEvent(cachereq));
+        delete serverev;
+    }
+    return false;
+}
+
+bool websiteServer::updateTick( SST::Cycle_t currentCycle ) {
+    // update the configured pages in turn
+    std::string updated = updatePages[nextUpdate];
+    nextUpdate = (nextUpdate + 1) % updatePages.size();
+    websites[updated].websiteVersion++;
+    pagesUpdated++;
+    output.verbose(CALL_INFO, 2, 0, "updated %s to %s \n", updated.c_str(), pageUrl(websites[updated]).c_str());
+
+    // invalidations queue behind the pages already on the link, so a copy 
+    // of the old version sent before the update cannot arrive after them
+    if (invalidationMode == "broadcast") {
+        // an empty page name invalidates everything the cache holds
+        struct CacheRequest cachereq = { INVALIDATION, 0, "", "", 0 };
+        websiteCache->send(transferDelay(0), new CacheRequestEvent(cachereq));
+        return false;
+    }
+
+    // walk the dependency map from the updated page, each page is only 
+    // invalidated once even if several pages depend on it
+    std::vector<std::string> toVisit = { updated };
+    std::set<std::string> invalidated;
+    while (!toVisit.empty()) {
+        std::string page = toVisit.back();
+        toVisit.pop_back();
+        if (!invalidated.insert(page).second) {
+            continue;
+        }
+        struct CacheRequest cachereq = { INVALIDATION, 0, page, "", 0 };
+        websiteCache->send(transferDelay(0), new CacheRequestEvent(cachereq));
+        for (const std::string &dependent : dependentPages[page]) {
+            toVisit.push_back(dependent);
         }
     }
     return false;
 }
 
+std::string websiteServer::pageUrl(const websitePage &page) {
+    if (page.websiteVersion == 0) {
+        return page.websiteUrl;
+    }
+    return page.websiteUrl + "?v=" + std::to_string(page.websiteVersion);
+}
+
+SST::SimTime_t websiteServer::transferDelay(uint64_t bytes) {
+    // a payload starts once the ones already on the link have been sent, 
+    // link time base is 1ns, so convert the transfer time to nanoseconds
+    SST::SimTime_t now = getCurrentSimTimeNano();
+    linkBusyUntil = std::max(now, linkBusyUntil) + (SST::SimTime_t)(bytes * 1e9 / linkBandwidth);
+    return linkBusyUntil - now;
+}
+
 void websiteServer::handleEvent(SST::Event *ev) {
     // push all requests to server to a queue
     ServerRequestEvent *serverev = dynamic_cast<ServerRequestEvent*>(ev);
+    if ( serverev == NULL ) {
+        output.output(CALL_INFO, "ignoring an unexpected event \n");
+        delete ev;
+        return;
+    }
+    // a retry of a request that is still queued is merged into it
+    // id 0 is the cache refreshing a page on its own, which has no key
+    if (idempotentRetries && serverev->serverreq.id != 0 && !requestKeys.admit(serverev->serverreq.id, serverev->serverreq.sequence)) {
+        output.verbose(CALL_INFO, 2, 0, "merging retry from user %d into its queued request \n", (int)serverev->serverreq.id);
+        supersededRequests++;
+        delete serverev;
+        return;
+    }
     memoryRequests.push(serverev);
-    output.output(CALL_INFO, "number of server requests: %ld \n", memoryRequests.size());
+    output.verbose(CALL_INFO, 2, 0, "number of server requests: %ld \n", memoryRequests.size());
 }
@@ -7,7 +7,11 @@
 #include <sst/core/event.h>
 #include <map>
 #include <queue>
+#include <set>
+#include <vector>
 #include "requests.h"
+#include "requestKeys.h"
+#include "timeSeriesSampler.h"
 
 /**
  * @file websiteServer.h
@@ -34,6 +38,19 @@ public:
 	 */
 	~websiteServer();
 
+	/**
+	 * @brief Sets up the sampler, if one was loaded
+	 * 
+	 */
+	void setup();
+
+	/**
+	 * @brief Logs how many requests were processed, and how many were 
+	 * dropped as superseded, during the simulation
+	 * 
+	 */
+	void finish();
+
 	/**
 	 * @brief This clock function checks the queue, and processes 
 	 * a defined amount of requests every cycle.
@@ -43,6 +60,23 @@ public:
 	 */
 	bool clockTick( SST::Cycle_t currentCycle );
 
+	/**
+	 * @brief This clock function updates the next page in the update list, 
+	 * then sends the cache invalidations for it
+	 * 
+	 * @param currentCycle This tells us what cycle of the simulation we're on
+	 * @return This returns whether or not the simulation should continue 
+	 */
+	bool updateTick( SST::Cycle_t currentCycle );
+
+	/**
+	 * @brief Returns the url of the current version of a page
+	 * 
+	 * @param page The page in the catalog
+	 * @return std::string The url, with the version appended once updated
+	 */
+	std::string pageUrl(const websitePage &page);
+
 	/**
 	 * @brief This function recieves messages fromn the cache, and adds them to 
 	 * a queue to be processed in the clock function
@@ -52,6 +86,17 @@ public:
 	 */
     void handleEvent(SST::Event *ev);
 
+	/**
+	 * @brief Computes how long it takes to push a payload across the link 
+	 * to the cache, given the configured link bandwidth. Payloads queue 
+	 * behind the ones still being sent, and the link is marked busy until 
+	 * this one is through.
+	 * 
+	 * @param bytes Size of the payload being sent
+	 * @return SST::SimTime_t The delay until the payload arrives in nanoseconds
+	 */
+	SST::SimTime_t transferDelay(uint64_t bytes);
+
 	/**
 	 * \cond
 	 */
@@ -68,12 +113,26 @@ public:
 	// Parameter name, description, default value
 	SST_ELI_DOCUMENT_PARAMS(
 		{ "randomseed", "Random Seed for errors within simulation", "151515" },
+		{ "verbose", "Output verbosity, 2 prints every request, 1 only the end of simulation summary", "2" },
+		{ "websiteBrowsingLength", "How long the server takes to process a request", "5s" },
+		{ "linkBandwidth", "Bandwidth of the link to the cache, used to model page transfer time", "1GB/s" },
+		{ "idempotentRetries", "Drop queued requests that a user's retry or newer request replaced", "false" },
+		{ "updateInterval", "How often a page is updated and invalidated, 0s disables updates", "0s" },
+		{ "updatePages", "Pages to update in turn, defaults to every page", "[]" },
+		{ "invalidationMode", "broadcast invalidates every cached page per update, dependency only the updated page and its dependents", "dependency" },
+		{ "pageDependencies", "List of 'page:dependent' entries, invalidating page also invalidates dependent", "[]" },
+		{ "pageSizes", "Overrides catalog page sizes, as a list of 'page:bytes' entries", "[]" },
 	)
 
 	// Port name, description, event type
 	SST_ELI_DOCUMENT_PORTS(
 		{ "websiteCache", "Communication to website cache", {"sst.Interfaces.StringEvent", "websiteCache"}},
 	)
+
+	// Subcomponent slot name, description, interface
+	SST_ELI_DOCUMENT_SUBCOMPONENT_SLOTS(
+		{ "sampler", "Optional sampler recording queue depth over time", "timeSeriesSampler" },
+	)
 	/**
 	 * \endcond
 	 */
@@ -90,9 +149,22 @@ private:
 	std::string websiteBrowsingLength; // defines clock frequency
 
 
-    std::map<std::string, std::string> websites;	// map to model cache
+    std::map<std::string, websitePage> websites;	// catalog of urls and page sizes
     std::queue<ServerRequestEvent*> memoryRequests; // queue to hold requests
     int maxQueueSize;
+    double linkBandwidth;							// bytes per second to the cache
+    SST::SimTime_t linkBusyUntil;					// time in ns the link finishes its queued payloads
+    timeSeriesSampler *sampler;						// optional sampler, NULL if not loaded
+    uint64_t requestsProcessed;						// requests taken off the queue
+    bool idempotentRetries;							// whether duplicate requests are removed
+    supersededFilter requestKeys;					// drops queued requests a user has replaced
+
+    std::vector<std::string> updatePages;			// pages updated in turn by updateTick
+    size_t nextUpdate;								// index in updatePages of the next update
+    uint64_t pagesUpdated;
+    std::string invalidationMode;					// broadcast or dependency
+    std::map<std::string, std::vector<std::string>> dependentPages;	// pages invalidated along with each page
+    uint64_t supersededRequests;					// requests dropped or merged before processing
 };
 
 #endif
\ No newline at end of file
@@ -12,15 +12,16 @@
 
 websiteUser::websiteUser( SST::ComponentId_t id, SST::Params& params ) : SST::Component(id) {
 	
-    // initalizes the name of each user for our output
-	output.init("websiteUser-" + getName() + "-> ", 1, 0, SST::Output::STDOUT);
+    // initalizes the name of each user for our output, per cycle messages 
+    // are only printed with verbose set to 2 or higher
+	output.init("websiteUser-" + getName() + "-> ", params.find<uint32_t>("verbose", 2), 0, SST::Output::STDOUT);
 
 	// This grabs the parameters that were defined in the python test file in 
     // order to initalize our component
 	websiteBrowsingLength = params.find<std::string>("websiteBrowsingLength", "10s");
     websiteRefreshLength = params.find<std::string>("websiteRefreshLength", "2s");
 	requestTimeoutLength = params.find<int64_t>("requestTimeoutLength", 5);
-    userID = params.find<int8_t>("id", 1);
+    userID = params.find<int64_t>("id", 1);
 
     // initialization of internal variables
     // user knows the names of the websites they can potentially visit
@@ -28,6 +29,7 @@ websiteUser::websiteUser( SST::ComponentId_t id, SST::Params& params ) : SST::Co
     listOfPages = {"home", "login", "profile1", "profile2", "profile3", "profile4", "settings", "about"};
     currentWebsite = "none";
     currentStatus = REQUESTING;
+    sequence = 0;
 
     /*
      * The register clock functions take in a duration of time that was defined 
@@ -48,6 +50,16 @@ websiteUser::websiteUser( SST::ComponentId_t id, SST::Params& params ) : SST::Co
     registerAsPrimaryComponent();
     primaryComponentDoNotEndSim();
 	
+	// load the optional sampler, each state is recorded as 0 or 1 so summing 
+	// the files from every user gives the number of users in each state
+	sampler = loadUserSubComponent<timeSeriesSampler>("sampler");
+	if ( sampler ) {
+		sampler->addProbe("browsing", [this]() { return (double)(currentStatus == BROWSING); });
+		sampler->addProbe("refreshing", [this]() { return (double)(currentStatus == REFRESHING); });
+		sampler->addProbe("requesting", [this]() { return (double)(currentStatus == REQUESTING); });
+		sampler->addProbe("waiting", [this]() { return (double)(currentStatus == WAITING); });
+	}
+
 	// Configure our port, which links us to other components in the simulation
 	websiteCache = configureLink("websiteCache", "1ns", new SST::Event::Handler<websiteUser>(this, &websiteUser::handleEvent));
 	if ( !websiteCache ) {
@@ -60,23 +72,36 @@ websiteUser::~websiteUser() {
 }
 
 void websiteUser::setup() {
+    // SST only sets up components, so the sampler is set up from here
+    if ( sampler ) {
+        sampler->setup();
+    }
+
     // randomize grab of first website
     int temp = (int)(rng->generateNextInt32());          
     currentWebsiteRequest = abs((int)(temp % 8));   
     std::string pageRequest = listOfPages.at(currentWebsiteRequest);
-    output.output(CALL_INFO, "is now requesting %s \n", pageRequest.c_str());
+    output.verbose(CALL_INFO, 2, 0, "is now requesting %s \n", pageRequest.c_str());
 
     // request the url of this website from the cache
-    struct CacheRequest cachereq = { USER, userID, pageRequest, "", 0 };
+    retryCount = 0;
+    sequence++;
+    struct CacheRequest cachereq = { USER, userID, pageRequest, "", 0, 0, retryCount, sequence };
     websiteCache->send(new CacheRequestEvent(cachereq));
 }
 
+void websiteUser::finish() {
+    if ( sampler ) {
+        sampler->finish();
+    }
+}
+
 bool websiteUser::clockTick( SST::Cycle_t currentCycle ) {
     // clock based on websiteBrowsingLength
-    output.output(CALL_INFO, "Sim-Time: %ld\n", getCurrentSimTimeNano());
+    output.verbose(CALL_INFO, 2, 0, "Sim-Time: %ld\n", getCurrentSimTimeNano());
     if (currentStatus == BROWSING) {
         // browse for one cycle, then request on the next
-        output.output(CALL_INFO, "is now browsing\n");
+        output.verbose(CALL_INFO, 2, 0, "is now browsing\n");
         currentStatus = REQUESTING;
     } else if (currentStatus == REFRESHING) {
         // do nothing, let waitingClock take care of this
@@ -85,8 +110,10 @@ bool websiteUser::clockTick( SST::Cycle_t currentCycle ) {
         int temp = (int)(rng->generateNextInt32());          
         currentWebsiteRequest = abs((int)(temp % 8));  
         std::string pageRequest = listOfPages.at(currentWebsiteRequest);
-        output.output(CALL_INFO, "is now requesting %s \n", pageRequest.c_str());
-        struct CacheRequest cachereq = { USER, userID, pageRequest, "", 0 };
+        output.verbose(CALL_INFO, 2, 0, "is now requesting %s \n", pageRequest.c_str());
+        retryCount = 0;
+        sequence++;
+        struct CacheRequest cachereq = { USER, userID, pageRequest, "", 0, 0, retryCount, sequence };
         websiteCache->send(new CacheRequestEvent(cachereq));
         currentStatus = WAITING;
         startWaitingCycle = currentCycle;
@@ -100,15 +127,16 @@ bool websiteUser::waitingTick( SST::Cycle_t currentCycle ) {
         // being impatient, send another request for same website
         // essentially refreshing the page after it times out
         std::string pageRequest = listOfPages.at(currentWebsiteRequest);
-        output.output(CALL_INFO, "is now re-requesting %s \n", pageRequest.c_str());
-        struct CacheRequest cachereq = { USER, userID, pageRequest, "", 0 };
+        output.verbose(CALL_INFO, 2, 0, "is now re-requesting %s \n", pageRequest.c_str());
+        retryCount++;
+        struct CacheRequest cachereq = { USER, userID, pageRequest, "", 0, 0, retryCount, sequence };
         websiteCache->send(new CacheRequestEvent(cachereq));
     }
     return false;
 }
 
 void websiteUser::handleEvent(SST::Event *ev) {
-    output.output(CALL_INFO, "event is being handled in user \n");
+    output.verbose(CALL_INFO, 2, 0, "event is being handled in user \n");
     UserRequestEvent *userev = dynamic_cast<UserRequestEvent*>(ev);
 	if ( userev != NULL ) {
         std::string websiteUrl = userev->userreq.websiteUrl;
@@ -7,6 +7,7 @@
 #include <sst/core/event.h>
 #include <vector>
 #include "requests.h"
+#include "timeSeriesSampler.h"
 
 /**
  * @file websiteUser.h
@@ -43,6 +44,12 @@ public:
 	 */
 	void setup();
 
+	/**
+	 * @brief Writes out the sampler's remaining samples, if one was loaded
+	 * 
+	 */
+	void finish();
+
 	/**
 	 * @brief This first clock function defines the general behavior of a 
 	 * user trying to access a website
@@ -102,6 +109,7 @@ public:
 	// Parameter name, description, default value
 	SST_ELI_DOCUMENT_PARAMS(
 		{ "websiteBrowsingLength", "How long to wait between checking user status", "10s" },
+		{ "verbose", "Output verbosity, 2 prints every cycle and request, 1 prints nothing", "2" },
 		{ "websiteRefreshLength", "How long to wait between impatiently waiting for a website", "2s" },
 		{ "requestTimeoutLength", "How many cycles to wait for a cache response", "5" },
 		{ "id", "id for the user", "1" },
@@ -111,6 +119,11 @@ public:
 	SST_ELI_DOCUMENT_PORTS(
 		{ "websiteCache", "Connecting port to the website cache", {"sst.Interfaces.StringEvent", "leftPort"}},
 	)
+
+	// Subcomponent slot name, description, interface
+	SST_ELI_DOCUMENT_SUBCOMPONENT_SLOTS(
+		{ "sampler", "Optional sampler recording the user state over time", "timeSeriesSampler" },
+	)
 	/**
 	 * \endcond
 	 */
@@ -133,6 +146,9 @@ private:
 	userStatus currentStatus;				/* status of the user */
 	SST::Cycle_t startWaitingCycle;			/* when a user started waiting for a cache response */
 	int currentWebsiteRequest;				/* spot in vector that holds the name of the website request */
+	int retryCount;							/* how many times the current request has been re-sent */
+	uint64_t sequence;						/* number of the current request, kept the same on retries */
+	timeSeriesSampler *sampler;				/* optional sampler, NULL if not loaded */
 };
 
 #endif
\ No newline at end of file